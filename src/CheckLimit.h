@@ -0,0 +1,48 @@
+#ifndef CHECKLIMIT_H
+#define CHECKLIMIT_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+
+// When a check may stop enumerating violations: after 'limit' of them, once
+// another check of the same run has failed and set 'abort', once the
+// caller has set 'cancel', or once the check's 'deadline' has passed. The
+// default never stops. Long loops also report the fraction of their work
+// done through 'progress'.
+struct CheckLimit
+{
+    size_t limit = 0;                       // 0 = no limit
+    const std::atomic<bool>* abort = nullptr;
+    const std::atomic<bool>* cancel = nullptr;
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+    // Set once the deadline has stopped the check, as opposed to the check
+    // finishing after it
+    std::atomic<bool>* deadline_hit = nullptr;
+    // May be called from several threads at once; empty reports nothing
+    std::function<void(float)> progress;
+
+    bool reached(size_t count) const { return limit != 0 && count >= limit; }
+    bool cancelled() const { return cancel && cancel->load(std::memory_order_relaxed); }
+    bool expired() const
+    {
+        if (deadline == std::chrono::steady_clock::time_point::max() || std::chrono::steady_clock::now() < deadline) {
+            return false;
+        }
+        if (deadline_hit) {
+            deadline_hit->store(true, std::memory_order_relaxed);
+        }
+        return true;
+    }
+    bool aborted() const { return (abort && abort->load(std::memory_order_relaxed)) || cancelled() || expired(); }
+    bool shouldStop(size_t count) const { return reached(count) || aborted(); }
+    void report(float fraction) const
+    {
+        if (progress) {
+            progress(fraction);
+        }
+    }
+};
+
+#endif // CHECKLIMIT_H
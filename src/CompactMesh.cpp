@@ -0,0 +1,82 @@
+#include "CompactMesh.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Elements per task for the conversions
+const size_t COMPACT_GRAIN = 1 << 16;
+
+const float QUANTIZATION_LEVELS = 65535.0f;
+
+} // namespace
+
+CompactMesh CompactMesh::fromMesh(const Mesh& mesh, bool quantize_positions)
+{
+    CompactMesh compact;
+
+    const size_t num_vertices = mesh.vertices.size();
+    BoundingBox box = mesh.getBoundingBox();
+    const glm::vec3 extent = box.max - box.min;
+    const bool finite = std::all_of(mesh.vertices.begin(), mesh.vertices.end(), [](const glm::vec3& p) {
+        return std::isfinite(p.x) && std::isfinite(p.y) && std::isfinite(p.z);
+    }) && std::isfinite(extent.x) && std::isfinite(extent.y) && std::isfinite(extent.z);
+    if (quantize_positions && finite && num_vertices > 0) {
+        compact.origin = box.min;
+        compact.step = extent / QUANTIZATION_LEVELS;
+        compact.quantized_positions.resize(num_vertices * 3);
+        Parallel::forRange(num_vertices, COMPACT_GRAIN, [&](size_t begin, size_t end) {
+            for (size_t v = begin; v < end; ++v) {
+                for (int axis = 0; axis < 3; ++axis) {
+                    const float scale = extent[axis] > 0.0f ? QUANTIZATION_LEVELS / extent[axis] : 0.0f;
+                    const float q = std::round((mesh.vertices[v][axis] - box.min[axis]) * scale);
+                    compact.quantized_positions[3 * v + axis] = static_cast<uint16_t>(std::min(q, QUANTIZATION_LEVELS));
+                }
+            }
+        });
+    } else {
+        compact.positions = mesh.vertices;
+    }
+
+    // Indices past the vertex array are kept as they are, so only go to 16
+    // bits when all of them fit.
+    bool short_indices = true;
+    for (unsigned int index : mesh.vertex_indices) {
+        if (index > 0xFFFF) {
+            short_indices = false;
+            break;
+        }
+    }
+    if (short_indices && !mesh.vertex_indices.empty()) {
+        compact.short_indices.resize(mesh.vertex_indices.size());
+        Parallel::forRange(mesh.vertex_indices.size(), COMPACT_GRAIN, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                compact.short_indices[i] = static_cast<uint16_t>(mesh.vertex_indices[i]);
+            }
+        });
+    } else {
+        compact.indices = mesh.vertex_indices;
+    }
+    return compact;
+}
+
+Mesh CompactMesh::toMesh() const
+{
+    Mesh mesh;
+    mesh.vertices.resize(vertexCount());
+    for (size_t v = 0; v < mesh.vertices.size(); ++v) {
+        mesh.vertices[v] = position(v);
+    }
+    mesh.vertex_indices.resize(indexCount());
+    for (size_t i = 0; i < mesh.vertex_indices.size(); ++i) {
+        mesh.vertex_indices[i] = index(i);
+    }
+    return mesh;
+}
+
+size_t CompactMesh::memoryBytes() const
+{
+    return positions.capacity() * sizeof(glm::vec3) + quantized_positions.capacity() * sizeof(uint16_t) +
+           indices.capacity() * sizeof(unsigned int) + short_indices.capacity() * sizeof(uint16_t);
+}
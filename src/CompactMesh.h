@@ -0,0 +1,64 @@
+#ifndef COMPACTMESH_H
+#define COMPACTMESH_H
+
+#include "Mesh.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Reduced copy of a mesh for batches that only run the topology and geometry
+// checks: positions and vertex indices, nothing else. Indices are stored in
+// 16 bits when every index fits, and positions can optionally be quantized to
+// 16 bits per axis on a grid spanning the bounding box. Compared with a Mesh
+// holding UVs this is 2-4x smaller.
+//
+// Quantization moves each position by about half a grid step per axis at
+// most (quantizationStep() / 2), so positions closer together than that may
+// coincide afterwards. Checks read dequantized positions through position().
+// That includes the topology checks: with repair_soup set, the CGAL soup
+// repair merges points that quantization made equal, which can close holes,
+// join or split components and change non-manifold counts.
+struct CompactMesh
+{
+    // Exactly one of each pair is populated
+    std::vector<glm::vec3> positions;
+    std::vector<uint16_t> quantized_positions; // x, y, z per vertex
+    std::vector<unsigned int> indices;
+    std::vector<uint16_t> short_indices;
+
+    // Dequantized position = origin + q * step
+    glm::vec3 origin = glm::vec3(0.0f);
+    glm::vec3 step = glm::vec3(0.0f);
+
+    // Positions are only quantized if the bounding box is finite.
+    static CompactMesh fromMesh(const Mesh& mesh, bool quantize_positions);
+
+    size_t vertexCount() const {
+        return isQuantized() ? quantized_positions.size() / 3 : positions.size();
+    }
+    size_t indexCount() const {
+        return hasShortIndices() ? short_indices.size() : indices.size();
+    }
+    bool isQuantized() const { return !quantized_positions.empty(); }
+    bool hasShortIndices() const { return !short_indices.empty(); }
+    glm::vec3 quantizationStep() const { return step; }
+
+    unsigned int index(size_t corner) const {
+        return hasShortIndices() ? short_indices[corner] : indices[corner];
+    }
+    glm::vec3 position(size_t vertex) const {
+        if (!isQuantized()) {
+            return positions[vertex];
+        }
+        const uint16_t* q = &quantized_positions[3 * vertex];
+        return origin + glm::vec3(q[0], q[1], q[2]) * step;
+    }
+
+    // Full Mesh with dequantized positions and 32-bit indices.
+    Mesh toMesh() const;
+
+    // Bytes held by the arrays above.
+    size_t memoryBytes() const;
+};
+
+#endif // COMPACTMESH_H
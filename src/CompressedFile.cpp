@@ -0,0 +1,188 @@
+#include "CompressedFile.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <zlib.h>
+
+#ifdef MESHCHECKER_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+// zlib counts input in 32-bit units, so large mappings are fed in slices
+const size_t MAX_INPUT_SLICE = 1u << 30;
+
+CompressedFile::~CompressedFile()
+{
+    close();
+}
+
+CompressedFile::Codec CompressedFile::detect(const std::string& path)
+{
+    unsigned char magic[4] = {0, 0, 0, 0};
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return Codec::None;
+    }
+    file.read(reinterpret_cast<char*>(magic), sizeof(magic));
+    const std::streamsize read = file.gcount();
+    if (read >= 2 && magic[0] == 0x1F && magic[1] == 0x8B) {
+        return Codec::Gzip;
+    }
+    if (read >= 4 && magic[0] == 0x28 && magic[1] == 0xB5 && magic[2] == 0x2F && magic[3] == 0xFD) {
+        return Codec::Zstd;
+    }
+    return Codec::None;
+}
+
+bool CompressedFile::isAvailable(Codec codec)
+{
+    switch (codec) {
+    case Codec::Gzip:
+        return true;
+    case Codec::Zstd:
+#ifdef MESHCHECKER_HAVE_ZSTD
+        return true;
+#else
+        return false;
+#endif
+    default:
+        return false;
+    }
+}
+
+bool CompressedFile::open(const std::string& path)
+{
+    close();
+
+    codec_ = detect(path);
+    if (codec_ == Codec::None) {
+        error_ = path + " is not a gzip or zstd file";
+        return false;
+    }
+    if (!isAvailable(codec_)) {
+        error_ = "zstd support is not compiled in (" + path + ")";
+        return false;
+    }
+    if (!file_.open(path)) {
+        error_ = "cannot open " + path;
+        return false;
+    }
+
+    if (codec_ == Codec::Gzip) {
+        z_stream* stream = new z_stream();
+        // 15 window bits + 32: accept both gzip and zlib headers
+        if (inflateInit2(stream, 15 + 32) != Z_OK) {
+            delete stream;
+            error_ = "cannot initialize zlib";
+            return false;
+        }
+        stream_ = stream;
+    }
+#ifdef MESHCHECKER_HAVE_ZSTD
+    else if (codec_ == Codec::Zstd) {
+        ZSTD_DStream* stream = ZSTD_createDStream();
+        if (!stream || ZSTD_isError(ZSTD_initDStream(stream))) {
+            ZSTD_freeDStream(stream);
+            error_ = "cannot initialize zstd";
+            return false;
+        }
+        stream_ = stream;
+    }
+#endif
+    return true;
+}
+
+void CompressedFile::close()
+{
+    if (stream_) {
+        if (codec_ == Codec::Gzip) {
+            z_stream* stream = static_cast<z_stream*>(stream_);
+            inflateEnd(stream);
+            delete stream;
+        }
+#ifdef MESHCHECKER_HAVE_ZSTD
+        else if (codec_ == Codec::Zstd) {
+            ZSTD_freeDStream(static_cast<ZSTD_DStream*>(stream_));
+        }
+#endif
+        stream_ = nullptr;
+    }
+    file_.close();
+    codec_ = Codec::None;
+    input_offset_ = 0;
+    zstd_status_ = 0;
+    finished_ = false;
+    error_.clear();
+}
+
+size_t CompressedFile::read(char* out, size_t capacity)
+{
+    if (!stream_ || finished_ || failed()) {
+        return 0;
+    }
+    const char* input = file_.data();
+    const size_t input_size = file_.size();
+    size_t produced = 0;
+
+    if (codec_ == Codec::Gzip) {
+        z_stream* stream = static_cast<z_stream*>(stream_);
+        while (produced < capacity) {
+            if (stream->avail_in == 0) {
+                if (input_offset_ >= input_size) {
+                    error_ = "truncated gzip stream";
+                    break;
+                }
+                const size_t slice = std::min(MAX_INPUT_SLICE, input_size - input_offset_);
+                stream->next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input + input_offset_));
+                stream->avail_in = static_cast<uInt>(slice);
+                input_offset_ += slice;
+            }
+            const size_t request = std::min<size_t>(capacity - produced, UINT_MAX);
+            stream->next_out = reinterpret_cast<Bytef*>(out + produced);
+            stream->avail_out = static_cast<uInt>(request);
+            const int status = inflate(stream, Z_NO_FLUSH);
+            produced += request - stream->avail_out;
+            if (status == Z_STREAM_END) {
+                // Concatenated gzip members (e.g. from pigz or appended logs)
+                if (stream->avail_in == 0 && input_offset_ >= input_size) {
+                    finished_ = true;
+                    break;
+                }
+                inflateReset(stream);
+            } else if (status != Z_OK && status != Z_BUF_ERROR) {
+                error_ = std::string("gzip: ") + (stream->msg ? stream->msg : "corrupt data");
+                break;
+            }
+        }
+    }
+#ifdef MESHCHECKER_HAVE_ZSTD
+    else if (codec_ == Codec::Zstd) {
+        ZSTD_DStream* stream = static_cast<ZSTD_DStream*>(stream_);
+        ZSTD_outBuffer output = {out, capacity, 0};
+        while (output.pos < output.size) {
+            // The status carries over between calls: a frame whose input is
+            // all read may still have output to flush into the next buffer
+            if (input_offset_ >= input_size && zstd_status_ == 0) {
+                finished_ = true;
+                break;
+            }
+            ZSTD_inBuffer in = {input, input_size, input_offset_};
+            const size_t before = output.pos;
+            zstd_status_ = ZSTD_decompressStream(stream, &output, &in);
+            input_offset_ = in.pos;
+            if (ZSTD_isError(zstd_status_)) {
+                error_ = std::string("zstd: ") + ZSTD_getErrorName(zstd_status_);
+                break;
+            }
+            // No input left and nothing more came out, yet the frame is not done
+            if (input_offset_ >= input_size && output.pos == before && zstd_status_ != 0) {
+                error_ = "truncated zstd stream";
+                break;
+            }
+        }
+        produced = output.pos;
+    }
+#endif
+    return produced;
+}
@@ -0,0 +1,47 @@
+#ifndef COMPRESSEDFILE_H
+#define COMPRESSEDFILE_H
+
+#include "MappedFile.h"
+#include <cstddef>
+#include <string>
+
+// Sequential decompressing reader over a memory-mapped gzip or zstd file.
+// zstd support is compiled in only when MESHCHECKER_HAVE_ZSTD is defined.
+class CompressedFile
+{
+public:
+    enum class Codec { None, Gzip, Zstd };
+
+    CompressedFile() = default;
+    ~CompressedFile();
+
+    CompressedFile(const CompressedFile&) = delete;
+    CompressedFile& operator=(const CompressedFile&) = delete;
+
+    // Identifies the codec from the magic bytes at the start of the file.
+    static Codec detect(const std::string& path);
+    static bool isAvailable(Codec codec);
+
+    bool open(const std::string& path);
+    void close();
+
+    // Decompresses up to capacity bytes into out. Returns the number of bytes
+    // written; 0 means end of stream or an error (see failed()).
+    size_t read(char* out, size_t capacity);
+
+    bool failed() const { return !error_.empty(); }
+    const std::string& error() const { return error_; }
+
+private:
+    MappedFile file_;
+    Codec codec_ = Codec::None;
+    void* stream_ = nullptr;
+    size_t input_offset_ = 0;
+    // Last ZSTD_decompressStream result: non-zero while the current frame
+    // still has input to read or output to flush
+    size_t zstd_status_ = 0;
+    bool finished_ = false;
+    std::string error_;
+};
+
+#endif // COMPRESSEDFILE_H
@@ -0,0 +1,135 @@
+#include "DegenerateChecker.h"
+#include "CompactMesh.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DEGENERATECHECKER_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+// Faces per task, and faces between two looks at the limit
+const size_t DEGENERATE_GRAIN = 1 << 14;
+const size_t LIMIT_BLOCK = 1024;
+
+using Bounds = DegenerateChecker::Bounds;
+
+// Appends the degenerate faces of [begin, end) to faces. Mesh access goes
+// through corner(i), the vertex of face corner i, and position(v).
+template <typename Corner, typename Position>
+void findRange(size_t begin, size_t end, size_t vertex_count, const Bounds& bounds,
+               const Corner& corner, const Position& position, std::vector<unsigned int>& faces)
+{
+    auto valid = [&](size_t f) {
+        return corner(3 * f) < vertex_count && corner(3 * f + 1) < vertex_count && corner(3 * f + 2) < vertex_count;
+    };
+    auto testScalar = [&](size_t f) {
+        if (valid(f) && DegenerateChecker::isDegenerate(position(corner(3 * f)), position(corner(3 * f + 1)), position(corner(3 * f + 2)), bounds)) {
+            faces.push_back(static_cast<unsigned int>(f));
+        }
+    };
+
+    size_t f = begin;
+#ifdef DEGENERATECHECKER_SSE2
+    // Two faces per step in double precision, the same arithmetic as above
+    const __m128d zero = _mm_setzero_pd();
+    const __m128d height_epsilon = _mm_set1_pd(bounds.height_epsilon_sq);
+    const __m128d min_area = _mm_set1_pd(bounds.area_sq_x4);
+    const __m128d aspect = _mm_set1_pd(bounds.aspect_sq);
+    for (; f + 2 <= end; f += 2) {
+        if (!valid(f) || !valid(f + 1)) {
+            testScalar(f);
+            testScalar(f + 1);
+            continue;
+        }
+        const glm::vec3 a0 = position(corner(3 * f)), a1 = position(corner(3 * f + 1)), a2 = position(corner(3 * f + 2));
+        const glm::vec3 b0 = position(corner(3 * f + 3)), b1 = position(corner(3 * f + 4)), b2 = position(corner(3 * f + 5));
+        const __m128d x0 = _mm_set_pd(b0.x, a0.x), y0 = _mm_set_pd(b0.y, a0.y), z0 = _mm_set_pd(b0.z, a0.z);
+        const __m128d x1 = _mm_set_pd(b1.x, a1.x), y1 = _mm_set_pd(b1.y, a1.y), z1 = _mm_set_pd(b1.z, a1.z);
+        const __m128d x2 = _mm_set_pd(b2.x, a2.x), y2 = _mm_set_pd(b2.y, a2.y), z2 = _mm_set_pd(b2.z, a2.z);
+
+        const __m128d v1x = _mm_sub_pd(x1, x0), v1y = _mm_sub_pd(y1, y0), v1z = _mm_sub_pd(z1, z0);
+        const __m128d v2x = _mm_sub_pd(x2, x0), v2y = _mm_sub_pd(y2, y0), v2z = _mm_sub_pd(z2, z0);
+        const __m128d v3x = _mm_sub_pd(x2, x1), v3y = _mm_sub_pd(y2, y1), v3z = _mm_sub_pd(z2, z1);
+
+        const __m128d a_sq = _mm_add_pd(_mm_add_pd(_mm_mul_pd(v1x, v1x), _mm_mul_pd(v1y, v1y)), _mm_mul_pd(v1z, v1z));
+        const __m128d b_sq = _mm_add_pd(_mm_add_pd(_mm_mul_pd(v2x, v2x), _mm_mul_pd(v2y, v2y)), _mm_mul_pd(v2z, v2z));
+        const __m128d c_sq = _mm_add_pd(_mm_add_pd(_mm_mul_pd(v3x, v3x), _mm_mul_pd(v3y, v3y)), _mm_mul_pd(v3z, v3z));
+
+        const __m128d nx = _mm_sub_pd(_mm_mul_pd(v1y, v2z), _mm_mul_pd(v1z, v2y));
+        const __m128d ny = _mm_sub_pd(_mm_mul_pd(v1z, v2x), _mm_mul_pd(v1x, v2z));
+        const __m128d nz = _mm_sub_pd(_mm_mul_pd(v1x, v2y), _mm_mul_pd(v1y, v2x));
+        const __m128d area_sq_x4 = _mm_add_pd(_mm_add_pd(_mm_mul_pd(nx, nx), _mm_mul_pd(ny, ny)), _mm_mul_pd(nz, nz));
+
+        const __m128d min_edge = _mm_min_pd(a_sq, _mm_min_pd(b_sq, c_sq));
+        const __m128d max_edge = _mm_max_pd(a_sq, _mm_max_pd(b_sq, c_sq));
+        const __m128d flat = _mm_or_pd(_mm_cmplt_pd(area_sq_x4, _mm_mul_pd(height_epsilon, max_edge)),
+                                       _mm_cmplt_pd(area_sq_x4, min_area));
+        const __m128d sliver = _mm_cmpgt_pd(_mm_mul_pd(max_edge, max_edge), _mm_mul_pd(aspect, area_sq_x4));
+        const int mask = _mm_movemask_pd(_mm_or_pd(_mm_cmpeq_pd(min_edge, zero), _mm_or_pd(flat, sliver)));
+        if (mask & 1) {
+            faces.push_back(static_cast<unsigned int>(f));
+        }
+        if (mask & 2) {
+            faces.push_back(static_cast<unsigned int>(f + 1));
+        }
+    }
+#endif
+    for (; f < end; ++f) {
+        testScalar(f);
+    }
+}
+
+template <typename Corner, typename Position>
+int findFaces(size_t num_faces, size_t vertex_count, const Corner& corner, const Position& position,
+              std::vector<unsigned int>& faces, const DegenerateThresholds& thresholds, const CheckLimit& limit)
+{
+    const Bounds bounds(thresholds);
+    faces.clear();
+    std::mutex faces_mutex;
+    std::atomic<size_t> found(0);
+    std::atomic<size_t> tested(0);
+    Parallel::forRange(num_faces, DEGENERATE_GRAIN, [&](size_t begin, size_t end) {
+        std::vector<unsigned int> local;
+        for (size_t block = begin; block < end && !limit.shouldStop(found.load(std::memory_order_relaxed)); block += LIMIT_BLOCK) {
+            const size_t before = local.size();
+            const size_t block_end = std::min(end, block + LIMIT_BLOCK);
+            findRange(block, block_end, vertex_count, bounds, corner, position, local);
+            found.fetch_add(local.size() - before, std::memory_order_relaxed);
+            limit.report(static_cast<float>(tested.fetch_add(block_end - block) + block_end - block) / num_faces);
+        }
+        std::lock_guard<std::mutex> lock(faces_mutex);
+        faces.insert(faces.end(), local.begin(), local.end());
+    });
+    std::sort(faces.begin(), faces.end());
+    if (limit.limit != 0 && faces.size() > limit.limit) {
+        faces.resize(limit.limit);
+    }
+    return static_cast<int>(faces.size());
+}
+
+} // namespace
+
+int DegenerateChecker::findDegenerateFaces(const Mesh& mesh, std::vector<unsigned int>& faces,
+                                           const DegenerateThresholds& thresholds, const CheckLimit& limit)
+{
+    const unsigned int* indices = mesh.vertex_indices.data();
+    const glm::vec3* vertices = mesh.vertices.data();
+    return findFaces(mesh.vertex_indices.size() / 3, mesh.vertices.size(),
+                     [indices](size_t i) { return indices[i]; },
+                     [vertices](unsigned int v) -> const glm::vec3& { return vertices[v]; },
+                     faces, thresholds, limit);
+}
+
+int DegenerateChecker::findDegenerateFaces(const CompactMesh& mesh, std::vector<unsigned int>& faces,
+                                           const DegenerateThresholds& thresholds, const CheckLimit& limit)
+{
+    return findFaces(mesh.indexCount() / 3, mesh.vertexCount(),
+                     [&mesh](size_t i) { return mesh.index(i); },
+                     [&mesh](unsigned int v) { return mesh.position(v); },
+                     faces, thresholds, limit);
+}
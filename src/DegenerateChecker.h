@@ -0,0 +1,80 @@
+#ifndef DEGENERATECHECKER_H
+#define DEGENERATECHECKER_H
+
+#include "Mesh.h"
+#include "CheckLimit.h"
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+struct CompactMesh;
+
+// Thresholds of DegenerateChecker
+struct DegenerateThresholds {
+    // A face with a zero-length edge, or whose squared height onto its
+    // longest edge is below this, is degenerate. The default is the test
+    // MeshChecker has always used.
+    double height_epsilon_sq = 1e-12;
+    // Faces with a smaller area are degenerate too; 0 disables
+    double min_area = 0.0;
+    // Slivers: longest edge / height onto it above this; 0 disables. An
+    // equilateral triangle has 2 / sqrt(3), about 1.15.
+    double max_aspect_ratio = 0.0;
+};
+
+// Degenerate and sliver faces, measured straight on the mesh positions. Two
+// faces are tested per SSE2 step in double precision, so the results match
+// the scalar test exactly, and face ranges run in parallel.
+class DegenerateChecker
+{
+public:
+    // Thresholds in the squared quantities the test computes. With n the
+    // cross product of two edges, |n|^2 = 4 area^2 = (height * longest edge)^2.
+    struct Bounds {
+        double height_epsilon_sq;
+        double area_sq_x4;   // (2 * min_area)^2
+        double aspect_sq;    // max_aspect_ratio^2, or infinity when disabled
+
+        explicit Bounds(const DegenerateThresholds& thresholds)
+            : height_epsilon_sq(thresholds.height_epsilon_sq),
+              area_sq_x4(4.0 * thresholds.min_area * thresholds.min_area),
+              aspect_sq(thresholds.max_aspect_ratio > 0.0 ? thresholds.max_aspect_ratio * thresholds.max_aspect_ratio
+                                                         : std::numeric_limits<double>::infinity())
+        {
+        }
+    };
+
+    // The test for one face. Other layouts with their own loops (MeshSoA,
+    // PagedMeshChecker) call this so that every path counts the same faces.
+    static bool isDegenerate(const glm::vec3& p1, const glm::vec3& p2, const glm::vec3& p3, const Bounds& bounds)
+    {
+        const double v1x = double(p2.x) - p1.x, v1y = double(p2.y) - p1.y, v1z = double(p2.z) - p1.z;
+        const double v2x = double(p3.x) - p1.x, v2y = double(p3.y) - p1.y, v2z = double(p3.z) - p1.z;
+        const double v3x = double(p3.x) - p2.x, v3y = double(p3.y) - p2.y, v3z = double(p3.z) - p2.z;
+        const double a_sq = v1x * v1x + v1y * v1y + v1z * v1z;
+        const double b_sq = v2x * v2x + v2y * v2y + v2z * v2z;
+        const double c_sq = v3x * v3x + v3y * v3y + v3z * v3z;
+        if (a_sq == 0 || b_sq == 0 || c_sq == 0) {
+            return true;
+        }
+        const double nx = v1y * v2z - v1z * v2y;
+        const double ny = v1z * v2x - v1x * v2z;
+        const double nz = v1x * v2y - v1y * v2x;
+        const double area_sq_x4 = nx * nx + ny * ny + nz * nz;
+        const double max_edge = std::max({a_sq, b_sq, c_sq});
+        // Longest edge / height > ratio  <=>  max_edge^2 > ratio^2 * |n|^2
+        return area_sq_x4 < bounds.height_epsilon_sq * max_edge || area_sq_x4 < bounds.area_sq_x4 ||
+               max_edge * max_edge > bounds.aspect_sq * area_sq_x4;
+    }
+
+    // Returns the number of degenerate faces and sets faces to their sorted
+    // indices. Faces with out-of-range indices are skipped. Once 'limit'
+    // says to stop, the search ends early and at most limit.limit faces
+    // are returned. Progress is reported to 'limit' as face blocks finish.
+    static int findDegenerateFaces(const Mesh& mesh, std::vector<unsigned int>& faces,
+                                   const DegenerateThresholds& thresholds = DegenerateThresholds(), const CheckLimit& limit = CheckLimit());
+    static int findDegenerateFaces(const CompactMesh& mesh, std::vector<unsigned int>& faces,
+                                   const DegenerateThresholds& thresholds = DegenerateThresholds(), const CheckLimit& limit = CheckLimit());
+};
+
+#endif // DEGENERATECHECKER_H
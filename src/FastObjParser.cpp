@@ -0,0 +1,483 @@
+#include "FastObjParser.h"
+#include "CompressedFile.h"
+#include "MappedFile.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iterator>
+#include <limits>
+
+// Below this size the file is parsed as a single chunk.
+const size_t MIN_CHUNK_SIZE = 1 << 20;
+
+// Decompressed bytes handed to a parser task at a time, and the number of
+// blocks beyond one per thread that may be pending before decompression
+// pauses.
+const size_t STREAM_BLOCK_SIZE = 4 << 20;
+const size_t MAX_QUEUED_BLOCKS = 4;
+
+// Texcoord or normal index that fails validation in merge: a 0, or a
+// relative index reaching before the first element. -1 means absent, so it
+// cannot mark these.
+const int INVALID_INDEX = std::numeric_limits<int>::min();
+
+namespace {
+
+inline bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+inline const char* skipSpaces(const char* p, const char* end)
+{
+    while (p < end && isSpace(*p)) {
+        ++p;
+    }
+    return p;
+}
+
+inline bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+const double POW10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+// Parses a decimal float. Falls back to strtod for anything unusual (inf, nan,
+// hex floats, very long mantissas).
+const char* parseFloat(const char* p, const char* end, float& out)
+{
+    const char* start = p;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        ++p;
+    }
+
+    uint64_t mantissa = 0;
+    int significant_digits = 0;
+    int exponent = 0;
+    bool any_digits = false;
+
+    while (p < end && isDigit(*p)) {
+        any_digits = true;
+        if (significant_digits < 19) {
+            mantissa = mantissa * 10 + (*p - '0');
+            if (mantissa != 0) significant_digits++;
+        } else {
+            exponent++;
+        }
+        ++p;
+    }
+    if (p < end && *p == '.') {
+        ++p;
+        while (p < end && isDigit(*p)) {
+            any_digits = true;
+            if (significant_digits < 19) {
+                mantissa = mantissa * 10 + (*p - '0');
+                if (mantissa != 0) significant_digits++;
+                exponent--;
+            }
+            ++p;
+        }
+    }
+
+    if (!any_digits) {
+        char buffer[64];
+        size_t length = 0;
+        while (start + length < end && !isSpace(start[length]) && start[length] != '\n' && length < sizeof(buffer) - 1) {
+            buffer[length] = start[length];
+            length++;
+        }
+        buffer[length] = '\0';
+        char* parsed_end = nullptr;
+        out = std::strtof(buffer, &parsed_end);
+        return start + (parsed_end - buffer);
+    }
+
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        const char* exp_start = p;
+        ++p;
+        bool exp_negative = false;
+        if (p < end && (*p == '-' || *p == '+')) {
+            exp_negative = *p == '-';
+            ++p;
+        }
+        if (p < end && isDigit(*p)) {
+            int value = 0;
+            while (p < end && isDigit(*p)) {
+                if (value < 10000) value = value * 10 + (*p - '0');
+                ++p;
+            }
+            exponent += exp_negative ? -value : value;
+        } else {
+            p = exp_start;
+        }
+    }
+
+    double value = static_cast<double>(mantissa);
+    if (exponent < 0) {
+        value = exponent >= -22 ? value / POW10[-exponent] : value * std::pow(10.0, exponent);
+    } else if (exponent > 0) {
+        value = exponent <= 22 ? value * POW10[exponent] : value * std::pow(10.0, exponent);
+    }
+    out = static_cast<float>(negative ? -value : value);
+    return p;
+}
+
+// Parses an OBJ index. Returns false if no integer is present.
+inline const char* parseInt(const char* p, const char* end, int& out, bool& found)
+{
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        ++p;
+    }
+    found = false;
+    int value = 0;
+    while (p < end && isDigit(*p)) {
+        value = value * 10 + (*p - '0');
+        found = true;
+        ++p;
+    }
+    out = negative ? -value : value;
+    return p;
+}
+
+const char* parseFloats(const char* p, const char* end, std::vector<float>& values, int required, int optional)
+{
+    for (int i = 0; i < required + optional; ++i) {
+        p = skipSpaces(p, end);
+        if (p >= end || *p == '\n') {
+            if (i < required) {
+                values.push_back(0.0f);
+                continue;
+            }
+            break;
+        }
+        float value;
+        const char* next = parseFloat(p, end, value);
+        if (next == p) {
+            // Not a number, treat the rest of the line as absent
+            if (i < required) {
+                values.push_back(0.0f);
+                continue;
+            }
+            break;
+        }
+        if (i < required) {
+            values.push_back(value);
+        }
+        p = next;
+    }
+    return p;
+}
+
+void parseFace(const char* p, const char* end, ObjChunk& chunk, bool parse_texcoords, bool parse_normals,
+               std::vector<tinyobj::index_t>& polygon, std::vector<ObjChunk::RelativeIndex>& polygon_relative)
+{
+    const int position_count = static_cast<int>(chunk.positions.size() / 3);
+    const int texcoord_count = static_cast<int>(chunk.texcoords.size() / 2);
+    const int normal_count = static_cast<int>(chunk.normals.size() / 3);
+
+    polygon.clear();
+    polygon_relative.clear();
+
+    // Relative indices are first recorded against the polygon and re-targeted
+    // to the triangulated corners below.
+    while (true) {
+        p = skipSpaces(p, end);
+        if (p >= end || *p == '\n' || *p == '#') {
+            break;
+        }
+
+        tinyobj::index_t index = {-1, -1, -1};
+        int raw = 0;
+        bool found = false;
+        p = parseInt(p, end, raw, found);
+        if (!found) {
+            break;
+        }
+        size_t slot = polygon.size();
+        if (raw < 0) polygon_relative.push_back({slot, 0, position_count});
+        index.vertex_index = raw > 0 ? raw - 1 : (raw < 0 ? raw : -1);
+
+        if (p < end && *p == '/') {
+            ++p;
+            if (p < end && *p != '/') {
+                p = parseInt(p, end, raw, found);
+                if (found && parse_texcoords) {
+                    if (raw < 0) polygon_relative.push_back({slot, 1, texcoord_count});
+                    index.texcoord_index = raw > 0 ? raw - 1 : (raw < 0 ? raw : INVALID_INDEX);
+                }
+            }
+            if (p < end && *p == '/') {
+                ++p;
+                p = parseInt(p, end, raw, found);
+                if (found && parse_normals) {
+                    if (raw < 0) polygon_relative.push_back({slot, 2, normal_count});
+                    index.normal_index = raw > 0 ? raw - 1 : (raw < 0 ? raw : INVALID_INDEX);
+                }
+            }
+        }
+        polygon.push_back(index);
+
+        // Skip anything unexpected up to the next separator
+        while (p < end && !isSpace(*p) && *p != '\n') {
+            ++p;
+        }
+    }
+
+    if (polygon.size() < 3) {
+        return;
+    }
+
+    // Fan triangulation
+    for (size_t k = 1; k + 1 < polygon.size(); ++k) {
+        const size_t slots[3] = {0, k, k + 1};
+        for (size_t slot : slots) {
+            size_t corner = chunk.corners.size();
+            chunk.corners.push_back(polygon[slot]);
+            for (const auto& relative : polygon_relative) {
+                if (relative.corner == slot) {
+                    chunk.relative_indices.push_back({corner, relative.component, relative.local_count});
+                }
+            }
+        }
+    }
+}
+
+} // namespace
+
+void FastObjParser::parseChunk(const char* begin, const char* end, ObjChunk& chunk, bool parse_texcoords, bool parse_normals)
+{
+    std::vector<tinyobj::index_t> polygon;
+    std::vector<ObjChunk::RelativeIndex> polygon_relative;
+
+    const char* p = begin;
+    while (p < end) {
+        const char* line_end = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        if (!line_end) {
+            line_end = end;
+        }
+
+        const char* q = skipSpaces(p, line_end);
+        if (q + 1 < line_end) {
+            if (q[0] == 'v') {
+                if (isSpace(q[1])) {
+                    parseFloats(q + 2, line_end, chunk.positions, 3, 0);
+                } else if (q[1] == 't' && parse_texcoords && q + 2 < line_end && isSpace(q[2])) {
+                    parseFloats(q + 3, line_end, chunk.texcoords, 2, 0);
+                } else if (q[1] == 'n' && parse_normals && q + 2 < line_end && isSpace(q[2])) {
+                    parseFloats(q + 3, line_end, chunk.normals, 3, 0);
+                }
+            } else if (q[0] == 'f' && isSpace(q[1])) {
+                parseFace(q + 2, line_end, chunk, parse_texcoords, parse_normals, polygon, polygon_relative);
+            }
+        }
+
+        p = line_end + 1;
+    }
+}
+
+bool FastObjParser::merge(std::vector<ObjChunk>& chunks, tinyobj::attrib_t& attrib, std::vector<tinyobj::shape_t>& shapes, std::string& err,
+                          bool keep_chunk_storage)
+{
+    const size_t num_chunks = chunks.size();
+    std::vector<size_t> position_base(num_chunks + 1, 0);
+    std::vector<size_t> texcoord_base(num_chunks + 1, 0);
+    std::vector<size_t> normal_base(num_chunks + 1, 0);
+    std::vector<size_t> corner_base(num_chunks + 1, 0);
+    for (size_t i = 0; i < num_chunks; ++i) {
+        position_base[i + 1] = position_base[i] + chunks[i].positions.size();
+        texcoord_base[i + 1] = texcoord_base[i] + chunks[i].texcoords.size();
+        normal_base[i + 1] = normal_base[i] + chunks[i].normals.size();
+        corner_base[i + 1] = corner_base[i] + chunks[i].corners.size();
+    }
+
+    attrib.vertices.resize(position_base[num_chunks]);
+    attrib.texcoords.resize(texcoord_base[num_chunks]);
+    attrib.normals.resize(normal_base[num_chunks]);
+
+    // The first shape is kept, with its index storage, when shapes is reused
+    shapes.resize(1);
+    tinyobj::shape_t& shape = shapes.front();
+    shape.name.clear();
+    shape.lines = tinyobj::lines_t();
+    shape.points = tinyobj::points_t();
+    tinyobj::mesh_t& mesh = shape.mesh;
+    mesh.material_ids.clear();
+    mesh.smoothing_group_ids.clear();
+    mesh.tags.clear();
+    mesh.indices.resize(corner_base[num_chunks]);
+    mesh.num_face_vertices.assign(corner_base[num_chunks] / 3, 3);
+
+    const long long num_positions = static_cast<long long>(position_base[num_chunks] / 3);
+    const long long num_texcoords = static_cast<long long>(texcoord_base[num_chunks] / 2);
+    const long long num_normals = static_cast<long long>(normal_base[num_chunks] / 3);
+    std::atomic<bool> valid(true);
+
+    Parallel::forRange(num_chunks, 1, [&](size_t begin, size_t end) {
+        for (size_t c = begin; c < end; ++c) {
+            ObjChunk& chunk = chunks[c];
+            const int bases[3] = {
+                static_cast<int>(position_base[c] / 3),
+                static_cast<int>(texcoord_base[c] / 2),
+                static_cast<int>(normal_base[c] / 3)
+            };
+
+            // Absolute indices are already global; relative ones are global
+            // once shifted by the number of elements before this chunk.
+            for (const auto& relative : chunk.relative_indices) {
+                tinyobj::index_t& index = chunk.corners[relative.corner];
+                int* component = relative.component == 0 ? &index.vertex_index
+                                 : relative.component == 1 ? &index.texcoord_index
+                                 : &index.normal_index;
+                const long long resolved = static_cast<long long>(bases[relative.component]) + relative.local_count + *component;
+                *component = resolved >= 0 ? static_cast<int>(resolved) : INVALID_INDEX;
+            }
+
+            for (const auto& index : chunk.corners) {
+                // -1 marks an absent texcoord or normal, INVALID_INDEX a bad one
+                if (index.vertex_index < 0 || index.vertex_index >= num_positions ||
+                    index.texcoord_index < -1 || index.texcoord_index >= num_texcoords ||
+                    index.normal_index < -1 || index.normal_index >= num_normals) {
+                    valid = false;
+                    break;
+                }
+            }
+
+            std::copy(chunk.positions.begin(), chunk.positions.end(), attrib.vertices.begin() + position_base[c]);
+            std::copy(chunk.texcoords.begin(), chunk.texcoords.end(), attrib.texcoords.begin() + texcoord_base[c]);
+            std::copy(chunk.normals.begin(), chunk.normals.end(), attrib.normals.begin() + normal_base[c]);
+            std::copy(chunk.corners.begin(), chunk.corners.end(), mesh.indices.begin() + corner_base[c]);
+
+            if (keep_chunk_storage) {
+                chunk.clear();
+            } else {
+                chunk = ObjChunk();
+            }
+        }
+    });
+
+    if (!valid) {
+        err = "face references an index outside the vertex/texcoord/normal arrays";
+        return false;
+    }
+    return true;
+}
+
+bool FastObjParser::parse(const std::string& path, tinyobj::attrib_t& attrib, std::vector<tinyobj::shape_t>& shapes, std::string& err,
+                          bool parse_texcoords, bool parse_normals, std::vector<ObjChunk>* chunk_buffers)
+{
+    MappedFile file;
+    if (!file.open(path)) {
+        err = "cannot open " + path;
+        return false;
+    }
+    return parseText(file.data(), file.size(), attrib, shapes, err, parse_texcoords, parse_normals, chunk_buffers);
+}
+
+bool FastObjParser::parseText(const char* data, size_t size, tinyobj::attrib_t& attrib, std::vector<tinyobj::shape_t>& shapes,
+                              std::string& err, bool parse_texcoords, bool parse_normals, std::vector<ObjChunk>* chunk_buffers)
+{
+    // Line-aligned chunk boundaries
+    size_t num_chunks = std::max<size_t>(1, std::min<size_t>(Parallel::threadCount(), size / MIN_CHUNK_SIZE));
+    std::vector<size_t> boundaries;
+    boundaries.push_back(0);
+    for (size_t i = 1; i < num_chunks; ++i) {
+        size_t position = std::max(boundaries.back(), size * i / num_chunks);
+        const void* newline = position < size ? std::memchr(data + position, '\n', size - position) : nullptr;
+        position = newline ? static_cast<const char*>(newline) - data + 1 : size;
+        boundaries.push_back(position);
+    }
+    boundaries.push_back(size);
+
+    std::vector<ObjChunk> local_chunks;
+    std::vector<ObjChunk>& chunks = chunk_buffers ? *chunk_buffers : local_chunks;
+    chunks.resize(num_chunks);
+    Parallel::forRange(num_chunks, 1, [&](size_t begin, size_t end) {
+        for (size_t c = begin; c < end; ++c) {
+            chunks[c].clear();
+            parseChunk(data + boundaries[c], data + boundaries[c + 1], chunks[c], parse_texcoords, parse_normals);
+        }
+    });
+
+    return merge(chunks, attrib, shapes, err, chunk_buffers != nullptr);
+}
+
+bool FastObjParser::parseCompressed(const std::string& path, tinyobj::attrib_t& attrib, std::vector<tinyobj::shape_t>& shapes, std::string& err,
+                                    bool parse_texcoords, bool parse_normals)
+{
+    CompressedFile file;
+    if (!file.open(path)) {
+        err = file.error();
+        return false;
+    }
+
+    // Each block is parsed by a scheduler task while this thread decompresses
+    // the next. A deque so that chunks referenced by running tasks survive
+    // growth.
+    std::deque<ObjChunk> chunks;
+    TaskGroup group;
+    size_t in_flight = 0;
+    const size_t max_in_flight = MAX_QUEUED_BLOCKS + Parallel::threadCount();
+
+    auto push = [&](std::string&& text) {
+        // Draining rather than blocking, as this thread may itself be a
+        // worker: a waiting worker runs the group's tasks itself
+        if (in_flight == max_in_flight) {
+            group.wait();
+            in_flight = 0;
+        }
+        chunks.emplace_back();
+        ObjChunk* chunk = &chunks.back();
+        group.run([chunk, text = std::move(text), parse_texcoords, parse_normals]() {
+            parseChunk(text.data(), text.data() + text.size(), *chunk, parse_texcoords, parse_normals);
+        });
+        ++in_flight;
+    };
+
+    // Each block ends at a newline; the partial last line carries over
+    std::string carry;
+    for (;;) {
+        std::string text = std::move(carry);
+        carry.clear();
+        const size_t kept = text.size();
+        text.resize(kept + STREAM_BLOCK_SIZE);
+        const size_t produced = file.read(&text[kept], STREAM_BLOCK_SIZE);
+        text.resize(kept + produced);
+        if (produced == 0) {
+            if (!text.empty()) {
+                push(std::move(text));
+            }
+            break;
+        }
+        const size_t newline = text.rfind('\n');
+        if (newline == std::string::npos) {
+            carry = std::move(text);
+            continue;
+        }
+        carry.assign(text, newline + 1, std::string::npos);
+        text.resize(newline + 1);
+        push(std::move(text));
+    }
+
+    group.wait();
+
+    if (file.failed()) {
+        err = path + ": " + file.error();
+        return false;
+    }
+
+    std::vector<ObjChunk> ordered(std::make_move_iterator(chunks.begin()), std::make_move_iterator(chunks.end()));
+    return merge(ordered, attrib, shapes, err);
+}
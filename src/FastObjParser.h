@@ -0,0 +1,63 @@
+#ifndef FASTOBJPARSER_H
+#define FASTOBJPARSER_H
+
+#include "tiny_obj_loader.h"
+#include <string>
+#include <vector>
+
+// Result of parsing one line-aligned slice of an OBJ file.
+struct ObjChunk {
+    std::vector<float> positions;
+    std::vector<float> texcoords;
+    std::vector<float> normals;
+    std::vector<tinyobj::index_t> corners; // Triangulated, three per face
+
+    // Negative (relative) OBJ indices can point into earlier chunks, so they are
+    // resolved only once the attribute counts of all preceding chunks are known.
+    struct RelativeIndex {
+        size_t corner;
+        int component; // 0 = position, 1 = texcoord, 2 = normal
+        int local_count;
+    };
+    std::vector<RelativeIndex> relative_indices;
+
+    // Empties the chunk without releasing its capacity
+    void clear()
+    {
+        positions.clear();
+        texcoords.clear();
+        normals.clear();
+        corners.clear();
+        relative_indices.clear();
+    }
+};
+
+// Memory-mapped OBJ parser that splits the file into line-aligned chunks and
+// parses them in parallel. Produces the same attrib/shape layout as tinyobj,
+// with polygons fan-triangulated into a single shape.
+class FastObjParser
+{
+public:
+    // Texcoord and normal lines are skipped entirely when not requested, and
+    // the corresponding corner indices are left at -1. With chunk_buffers the
+    // chunks are parsed into that vector and keep their capacity for the
+    // next call; attrib and shapes keep theirs as well.
+    static bool parse(const std::string& path, tinyobj::attrib_t& attrib, std::vector<tinyobj::shape_t>& shapes, std::string& err,
+                      bool parse_texcoords = true, bool parse_normals = true, std::vector<ObjChunk>* chunk_buffers = nullptr);
+    // Same, on text the caller has already mapped
+    static bool parseText(const char* data, size_t size, tinyobj::attrib_t& attrib, std::vector<tinyobj::shape_t>& shapes, std::string& err,
+                          bool parse_texcoords = true, bool parse_normals = true, std::vector<ObjChunk>* chunk_buffers = nullptr);
+
+    // Parses a gzip or zstd compressed OBJ. The calling thread decompresses
+    // line-aligned blocks and hands each to a scheduler task, so the
+    // decompressed text is never held in full.
+    static bool parseCompressed(const std::string& path, tinyobj::attrib_t& attrib, std::vector<tinyobj::shape_t>& shapes, std::string& err,
+                                bool parse_texcoords = true, bool parse_normals = true);
+
+    static void parseChunk(const char* begin, const char* end, ObjChunk& chunk, bool parse_texcoords = true, bool parse_normals = true);
+    // Merged chunks are freed, or only emptied with keep_chunk_storage
+    static bool merge(std::vector<ObjChunk>& chunks, tinyobj::attrib_t& attrib, std::vector<tinyobj::shape_t>& shapes, std::string& err,
+                      bool keep_chunk_storage = false);
+};
+
+#endif // FASTOBJPARSER_H
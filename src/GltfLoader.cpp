@@ -0,0 +1,604 @@
+#include "GltfLoader.h"
+#include "MappedFile.h"
+#include <QByteArray>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QUrl>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const uint32_t GLB_MAGIC = 0x46546C67;      // "glTF"
+const uint32_t GLB_CHUNK_JSON = 0x4E4F534A; // "JSON"
+const uint32_t GLB_CHUNK_BIN = 0x004E4942;  // "BIN\0"
+
+const int COMPONENT_BYTE = 5120;
+const int COMPONENT_UNSIGNED_BYTE = 5121;
+const int COMPONENT_SHORT = 5122;
+const int COMPONENT_UNSIGNED_SHORT = 5123;
+const int COMPONENT_UNSIGNED_INT = 5125;
+const int COMPONENT_FLOAT = 5126;
+
+const int MODE_TRIANGLES = 4;
+const int MODE_TRIANGLE_STRIP = 5;
+const int MODE_TRIANGLE_FAN = 6;
+
+struct BufferData {
+    const char* data = nullptr;
+    size_t size = 0;
+};
+
+// Typed, bounds-checked window into a buffer.
+struct Accessor {
+    const char* data = nullptr;
+    size_t count = 0;
+    size_t stride = 0;
+    int component_type = 0;
+    int components = 0;
+    bool normalized = false;
+};
+
+struct GltfFile {
+    QJsonObject json;
+    std::vector<BufferData> buffers;
+    // Storage behind buffers that do not live in the mapped input file
+    std::vector<QByteArray> decoded;
+    std::vector<std::unique_ptr<MappedFile>> external;
+};
+
+struct MeshInstance {
+    int mesh = -1;
+    glm::mat4 transform;
+};
+
+bool hostIsLittleEndian()
+{
+    const uint16_t probe = 1;
+    unsigned char first;
+    std::memcpy(&first, &probe, 1);
+    return first == 1;
+}
+
+const bool s_little_endian_host = hostIsLittleEndian();
+
+// glTF binary data is always little endian.
+template <typename T>
+T readLittleEndian(const char* p)
+{
+    unsigned char bytes[sizeof(T)];
+    std::memcpy(bytes, p, sizeof(T));
+    if (!s_little_endian_host) {
+        std::reverse(bytes, bytes + sizeof(T));
+    }
+    T value;
+    std::memcpy(&value, bytes, sizeof(T));
+    return value;
+}
+
+size_t componentSize(int component_type)
+{
+    switch (component_type) {
+    case COMPONENT_BYTE: case COMPONENT_UNSIGNED_BYTE: return 1;
+    case COMPONENT_SHORT: case COMPONENT_UNSIGNED_SHORT: return 2;
+    case COMPONENT_UNSIGNED_INT: case COMPONENT_FLOAT: return 4;
+    default: return 0;
+    }
+}
+
+int componentCount(const QString& type)
+{
+    if (type == "SCALAR") return 1;
+    if (type == "VEC2") return 2;
+    if (type == "VEC3") return 3;
+    if (type == "VEC4") return 4;
+    return 0;
+}
+
+size_t toSize(const QJsonValue& value)
+{
+    double number = value.toDouble(0.0);
+    return number > 0.0 ? static_cast<size_t>(number) : 0;
+}
+
+float readComponent(const char* p, int component_type, bool normalized)
+{
+    switch (component_type) {
+    case COMPONENT_FLOAT:
+        return readLittleEndian<float>(p);
+    case COMPONENT_UNSIGNED_BYTE: {
+        float value = static_cast<uint8_t>(*p);
+        return normalized ? value / 255.0f : value;
+    }
+    case COMPONENT_BYTE: {
+        float value = static_cast<int8_t>(*p);
+        return normalized ? std::max(value / 127.0f, -1.0f) : value;
+    }
+    case COMPONENT_UNSIGNED_SHORT: {
+        float value = readLittleEndian<uint16_t>(p);
+        return normalized ? value / 65535.0f : value;
+    }
+    case COMPONENT_SHORT: {
+        float value = readLittleEndian<int16_t>(p);
+        return normalized ? std::max(value / 32767.0f, -1.0f) : value;
+    }
+    case COMPONENT_UNSIGNED_INT:
+        return static_cast<float>(readLittleEndian<uint32_t>(p));
+    default:
+        return 0.0f;
+    }
+}
+
+unsigned int readIndex(const char* p, int component_type)
+{
+    switch (component_type) {
+    case COMPONENT_UNSIGNED_BYTE: return static_cast<uint8_t>(*p);
+    case COMPONENT_UNSIGNED_SHORT: return readLittleEndian<uint16_t>(p);
+    default: return readLittleEndian<uint32_t>(p);
+    }
+}
+
+glm::vec3 readVec3(const Accessor& accessor, size_t i)
+{
+    const char* p = accessor.data + i * accessor.stride;
+    const size_t size = componentSize(accessor.component_type);
+    return glm::vec3(readComponent(p, accessor.component_type, accessor.normalized),
+                     readComponent(p + size, accessor.component_type, accessor.normalized),
+                     readComponent(p + 2 * size, accessor.component_type, accessor.normalized));
+}
+
+bool resolveAccessor(const GltfFile& gltf, int index, Accessor& accessor)
+{
+    const QJsonArray accessors = gltf.json.value("accessors").toArray();
+    if (index < 0 || index >= accessors.size()) {
+        return false;
+    }
+    const QJsonObject object = accessors.at(index).toObject();
+    if (object.contains("sparse") || !object.contains("bufferView")) {
+        std::cerr << "GltfLoader: sparse accessors are not supported" << std::endl;
+        return false;
+    }
+
+    accessor.component_type = object.value("componentType").toInt();
+    accessor.components = componentCount(object.value("type").toString());
+    accessor.count = toSize(object.value("count"));
+    accessor.normalized = object.value("normalized").toBool(false);
+    const size_t element_size = componentSize(accessor.component_type) * accessor.components;
+    if (element_size == 0) {
+        return false;
+    }
+
+    const QJsonArray views = gltf.json.value("bufferViews").toArray();
+    const int view_index = object.value("bufferView").toInt(-1);
+    if (view_index < 0 || view_index >= views.size()) {
+        return false;
+    }
+    const QJsonObject view = views.at(view_index).toObject();
+    const int buffer_index = view.value("buffer").toInt(-1);
+    if (buffer_index < 0 || buffer_index >= static_cast<int>(gltf.buffers.size())) {
+        return false;
+    }
+    const BufferData& buffer = gltf.buffers[buffer_index];
+    const size_t view_offset = toSize(view.value("byteOffset"));
+    const size_t view_length = toSize(view.value("byteLength"));
+    const size_t offset = toSize(object.value("byteOffset"));
+    size_t stride = toSize(view.value("byteStride"));
+    if (stride == 0) {
+        stride = element_size;
+    }
+
+    if (view_offset > buffer.size || view_length > buffer.size - view_offset) {
+        return false;
+    }
+    if (accessor.count > 0) {
+        if (offset > view_length || element_size > view_length - offset) {
+            return false;
+        }
+        if (accessor.count - 1 > (view_length - offset - element_size) / stride) {
+            return false;
+        }
+    }
+
+    accessor.data = buffer.data + view_offset + offset;
+    accessor.stride = stride;
+    return true;
+}
+
+bool loadBuffers(const std::string& path, const char* bin, size_t bin_size, GltfFile& gltf)
+{
+    const QJsonArray buffers = gltf.json.value("buffers").toArray();
+    gltf.decoded.reserve(buffers.size());
+    for (int i = 0; i < buffers.size(); ++i) {
+        const QJsonObject buffer = buffers.at(i).toObject();
+        BufferData data;
+        if (!buffer.contains("uri")) {
+            // Only the first buffer of a .glb may omit the URI; it is the BIN chunk
+            if (i != 0 || !bin) {
+                std::cerr << "GltfLoader: buffer " << i << " has no data in " << path << std::endl;
+                return false;
+            }
+            data.data = bin;
+            data.size = bin_size;
+        } else {
+            const QString uri = buffer.value("uri").toString();
+            if (uri.startsWith("data:")) {
+                const int comma = uri.indexOf(',');
+                if (comma < 0 || !uri.left(comma).endsWith(";base64")) {
+                    std::cerr << "GltfLoader: unsupported data URI in " << path << std::endl;
+                    return false;
+                }
+                gltf.decoded.push_back(QByteArray::fromBase64(uri.mid(comma + 1).toLatin1()));
+                data.data = gltf.decoded.back().constData();
+                data.size = static_cast<size_t>(gltf.decoded.back().size());
+            } else {
+                fs::path buffer_path = fs::path(path).parent_path() / QUrl::fromPercentEncoding(uri.toUtf8()).toStdString();
+                auto file = std::make_unique<MappedFile>();
+                if (!file->open(buffer_path.string())) {
+                    std::cerr << "GltfLoader: cannot open buffer " << buffer_path.string() << std::endl;
+                    return false;
+                }
+                data.data = file->data();
+                data.size = file->size();
+                gltf.external.push_back(std::move(file));
+            }
+        }
+
+        const size_t byte_length = toSize(buffer.value("byteLength"));
+        if (data.size < byte_length) {
+            std::cerr << "GltfLoader: buffer " << i << " is truncated in " << path << std::endl;
+            return false;
+        }
+        data.size = byte_length;
+        gltf.buffers.push_back(data);
+    }
+    return true;
+}
+
+glm::mat4 localTransform(const QJsonObject& node)
+{
+    const QJsonArray matrix = node.value("matrix").toArray();
+    if (matrix.size() == 16) {
+        // Column major, as in glm
+        float values[16];
+        for (int i = 0; i < 16; ++i) {
+            values[i] = static_cast<float>(matrix.at(i).toDouble());
+        }
+        return glm::make_mat4(values);
+    }
+
+    glm::mat4 transform(1.0f);
+    const QJsonArray translation = node.value("translation").toArray();
+    if (translation.size() == 3) {
+        transform = glm::translate(transform, glm::vec3(translation.at(0).toDouble(), translation.at(1).toDouble(), translation.at(2).toDouble()));
+    }
+    const QJsonArray rotation = node.value("rotation").toArray();
+    if (rotation.size() == 4) {
+        // glTF stores x, y, z, w; glm::quat takes w first
+        glm::quat q(static_cast<float>(rotation.at(3).toDouble()), static_cast<float>(rotation.at(0).toDouble()),
+                    static_cast<float>(rotation.at(1).toDouble()), static_cast<float>(rotation.at(2).toDouble()));
+        transform = transform * glm::mat4_cast(q);
+    }
+    const QJsonArray scale = node.value("scale").toArray();
+    if (scale.size() == 3) {
+        transform = glm::scale(transform, glm::vec3(scale.at(0).toDouble(), scale.at(1).toDouble(), scale.at(2).toDouble()));
+    }
+    return transform;
+}
+
+void collectInstances(const QJsonArray& nodes, int node_index, const glm::mat4& parent, int depth, std::vector<MeshInstance>& instances)
+{
+    // The depth bound also stops malformed files with cyclic node graphs
+    if (node_index < 0 || node_index >= nodes.size() || depth > nodes.size()) {
+        return;
+    }
+    const QJsonObject node = nodes.at(node_index).toObject();
+    const glm::mat4 world = parent * localTransform(node);
+    if (node.contains("mesh")) {
+        instances.push_back({node.value("mesh").toInt(-1), world});
+    }
+    const QJsonArray children = node.value("children").toArray();
+    for (int i = 0; i < children.size(); ++i) {
+        collectInstances(nodes, children.at(i).toInt(-1), world, depth + 1, instances);
+    }
+}
+
+std::vector<MeshInstance> sceneInstances(const QJsonObject& json)
+{
+    std::vector<MeshInstance> instances;
+    const QJsonArray scenes = json.value("scenes").toArray();
+    const int scene = json.value("scene").toInt(0);
+    if (scene >= 0 && scene < scenes.size()) {
+        const QJsonArray nodes = json.value("nodes").toArray();
+        const QJsonArray roots = scenes.at(scene).toObject().value("nodes").toArray();
+        for (int i = 0; i < roots.size(); ++i) {
+            collectInstances(nodes, roots.at(i).toInt(-1), glm::mat4(1.0f), 0, instances);
+        }
+    } else {
+        // No scene: take every mesh untransformed
+        const int mesh_count = json.value("meshes").toArray().size();
+        for (int i = 0; i < mesh_count; ++i) {
+            instances.push_back({i, glm::mat4(1.0f)});
+        }
+    }
+    return instances;
+}
+
+struct AttributeState {
+    bool normals_incomplete = false;
+    size_t skipped_primitives = 0;
+};
+
+bool appendPrimitive(const GltfFile& gltf, const QJsonObject& primitive, const glm::mat4& transform,
+                     const MeshLoadOptions& options, Mesh& mesh, AttributeState& state)
+{
+    const int mode = primitive.value("mode").toInt(MODE_TRIANGLES);
+    if (mode != MODE_TRIANGLES && mode != MODE_TRIANGLE_STRIP && mode != MODE_TRIANGLE_FAN) {
+        ++state.skipped_primitives;
+        return true;
+    }
+
+    const QJsonObject attributes = primitive.value("attributes").toObject();
+    Accessor positions;
+    if (!resolveAccessor(gltf, attributes.value("POSITION").toInt(-1), positions) || positions.components != 3) {
+        std::cerr << "GltfLoader: primitive has no valid POSITION accessor" << std::endl;
+        return false;
+    }
+    const size_t base = mesh.vertices.size();
+    if (positions.count > static_cast<size_t>(UINT_MAX) - base) {
+        std::cerr << "GltfLoader: too many vertices" << std::endl;
+        return false;
+    }
+
+    const bool identity = transform == glm::mat4(1.0f);
+    const bool direct_floats = s_little_endian_host && positions.component_type == COMPONENT_FLOAT;
+
+    // --- Positions ---
+    mesh.vertices.resize(base + positions.count);
+    glm::vec3* out_positions = mesh.vertices.data() + base;
+    if (identity && direct_floats && positions.stride == sizeof(glm::vec3)) {
+        std::memcpy(out_positions, positions.data, positions.count * sizeof(glm::vec3));
+    } else if (identity && direct_floats) {
+        for (size_t i = 0; i < positions.count; ++i) {
+            std::memcpy(&out_positions[i], positions.data + i * positions.stride, sizeof(glm::vec3));
+        }
+    } else {
+        for (size_t i = 0; i < positions.count; ++i) {
+            out_positions[i] = glm::vec3(transform * glm::vec4(readVec3(positions, i), 1.0f));
+        }
+    }
+
+    // --- Normals ---
+    if (options.keep_normals && attributes.contains("NORMAL")) {
+        Accessor normals;
+        if (!resolveAccessor(gltf, attributes.value("NORMAL").toInt(-1), normals) ||
+            normals.components != 3 || normals.count != positions.count) {
+            std::cerr << "GltfLoader: invalid NORMAL accessor" << std::endl;
+            return false;
+        }
+        if (mesh.normals.size() < base) {
+            state.normals_incomplete = true;
+        }
+        mesh.normals.resize(base + normals.count);
+        glm::vec3* out_normals = mesh.normals.data() + base;
+        if (identity && s_little_endian_host && normals.component_type == COMPONENT_FLOAT && normals.stride == sizeof(glm::vec3)) {
+            std::memcpy(out_normals, normals.data, normals.count * sizeof(glm::vec3));
+        } else {
+            const glm::mat3 normal_matrix = glm::transpose(glm::inverse(glm::mat3(transform)));
+            for (size_t i = 0; i < normals.count; ++i) {
+                glm::vec3 normal = normal_matrix * readVec3(normals, i);
+                float len = glm::length(normal);
+                out_normals[i] = len > 0.0f ? normal / len : normal;
+            }
+        }
+    } else if (options.keep_normals) {
+        state.normals_incomplete = true;
+    }
+
+    // --- Texture coordinates ---
+    if (options.keep_uvs && attributes.contains("TEXCOORD_0")) {
+        Accessor uvs;
+        if (!resolveAccessor(gltf, attributes.value("TEXCOORD_0").toInt(-1), uvs) ||
+            uvs.components != 2 || uvs.count != positions.count) {
+            std::cerr << "GltfLoader: invalid TEXCOORD_0 accessor" << std::endl;
+            return false;
+        }
+        // Vertices of earlier primitives without UVs get (0, 0), as in ObjLoader
+        mesh.uvs.resize(base + uvs.count);
+        glm::vec2* out_uvs = mesh.uvs.data() + base;
+        if (s_little_endian_host && uvs.component_type == COMPONENT_FLOAT && uvs.stride == sizeof(glm::vec2)) {
+            std::memcpy(out_uvs, uvs.data, uvs.count * sizeof(glm::vec2));
+        } else {
+            const size_t size = componentSize(uvs.component_type);
+            for (size_t i = 0; i < uvs.count; ++i) {
+                const char* p = uvs.data + i * uvs.stride;
+                out_uvs[i] = glm::vec2(readComponent(p, uvs.component_type, uvs.normalized),
+                                       readComponent(p + size, uvs.component_type, uvs.normalized));
+            }
+        }
+    }
+
+    // --- Indices ---
+    const size_t first = mesh.vertex_indices.size();
+    Accessor indices;
+    const bool indexed = primitive.contains("indices");
+    if (indexed) {
+        if (!resolveAccessor(gltf, primitive.value("indices").toInt(-1), indices) || indices.components != 1 ||
+            (indices.component_type != COMPONENT_UNSIGNED_BYTE && indices.component_type != COMPONENT_UNSIGNED_SHORT &&
+             indices.component_type != COMPONENT_UNSIGNED_INT)) {
+            std::cerr << "GltfLoader: invalid indices accessor" << std::endl;
+            return false;
+        }
+    }
+    const size_t corner_count = indexed ? indices.count : positions.count;
+    auto corner = [&](size_t i) -> unsigned int {
+        return indexed ? readIndex(indices.data + i * indices.stride, indices.component_type) : static_cast<unsigned int>(i);
+    };
+
+    if (mode == MODE_TRIANGLES) {
+        const size_t count = corner_count - corner_count % 3;
+        mesh.vertex_indices.resize(first + count);
+        if (indexed && s_little_endian_host && indices.component_type == COMPONENT_UNSIGNED_INT && indices.stride == sizeof(unsigned int)) {
+            std::memcpy(mesh.vertex_indices.data() + first, indices.data, count * sizeof(unsigned int));
+        } else {
+            for (size_t i = 0; i < count; ++i) {
+                mesh.vertex_indices[first + i] = corner(i);
+            }
+        }
+    } else {
+        for (size_t i = 0; i + 2 < corner_count; ++i) {
+            if (mode == MODE_TRIANGLE_STRIP) {
+                // Every other triangle of a strip is flipped to keep the winding
+                const bool odd = (i % 2) != 0;
+                mesh.vertex_indices.push_back(corner(i));
+                mesh.vertex_indices.push_back(corner(odd ? i + 2 : i + 1));
+                mesh.vertex_indices.push_back(corner(odd ? i + 1 : i + 2));
+            } else {
+                mesh.vertex_indices.push_back(corner(i + 1));
+                mesh.vertex_indices.push_back(corner(i + 2));
+                mesh.vertex_indices.push_back(corner(0));
+            }
+        }
+    }
+
+    // Validate and rebase onto the merged vertex array in one pass
+    const unsigned int offset = static_cast<unsigned int>(base);
+    for (size_t i = first; i < mesh.vertex_indices.size(); ++i) {
+        if (mesh.vertex_indices[i] >= positions.count) {
+            std::cerr << "GltfLoader: vertex index out of range" << std::endl;
+            return false;
+        }
+        mesh.vertex_indices[i] += offset;
+    }
+
+    // Mirroring transforms flip the winding
+    if (!identity && glm::determinant(glm::mat3(transform)) < 0.0f) {
+        for (size_t i = first; i + 2 < mesh.vertex_indices.size(); i += 3) {
+            std::swap(mesh.vertex_indices[i + 1], mesh.vertex_indices[i + 2]);
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+bool GltfLoader::isGlb(const char* data, size_t size)
+{
+    return size >= 12 && readLittleEndian<uint32_t>(data) == GLB_MAGIC && readLittleEndian<uint32_t>(data + 4) == 2;
+}
+
+bool GltfLoader::load(const std::string& path, Mesh& mesh, const MeshLoadOptions& options)
+{
+    mesh.vertices.clear();
+    mesh.uvs.clear();
+    mesh.normals.clear();
+    mesh.vertex_indices.clear();
+    mesh.uv_indices.clear();
+    mesh.normal_indices.clear();
+
+    MappedFile file;
+    if (!file.open(path)) {
+        std::cerr << "GltfLoader: cannot open " << path << std::endl;
+        return false;
+    }
+    const char* data = file.data();
+    const size_t size = file.size();
+
+    // --- Container ---
+    QByteArray json_text;
+    const char* bin = nullptr;
+    size_t bin_size = 0;
+    if (isGlb(data, size)) {
+        const size_t length = std::min<size_t>(readLittleEndian<uint32_t>(data + 8), size);
+        const char* p = data + 12;
+        const char* end = data + length;
+        while (end - p >= 8) {
+            const size_t chunk_length = readLittleEndian<uint32_t>(p);
+            const uint32_t chunk_type = readLittleEndian<uint32_t>(p + 4);
+            p += 8;
+            if (chunk_length > static_cast<size_t>(end - p)) {
+                std::cerr << "GltfLoader: truncated chunk in " << path << std::endl;
+                return false;
+            }
+            // The JSON text is parsed in place, the BIN chunk is used where it is mapped
+            if (chunk_type == GLB_CHUNK_JSON && json_text.isEmpty()) {
+                json_text = QByteArray::fromRawData(p, static_cast<qsizetype>(chunk_length));
+            } else if (chunk_type == GLB_CHUNK_BIN && !bin) {
+                bin = p;
+                bin_size = chunk_length;
+            }
+            p += chunk_length;
+        }
+    } else {
+        json_text = QByteArray::fromRawData(data, static_cast<qsizetype>(size));
+    }
+
+    QJsonParseError parse_error;
+    const QJsonDocument document = QJsonDocument::fromJson(json_text, &parse_error);
+    if (parse_error.error != QJsonParseError::NoError || !document.isObject()) {
+        std::cerr << "GltfLoader: invalid JSON in " << path << ": " << parse_error.errorString().toStdString() << std::endl;
+        return false;
+    }
+
+    GltfFile gltf;
+    gltf.json = document.object();
+    if (!gltf.json.value("asset").toObject().value("version").toString().startsWith("2")) {
+        std::cerr << "GltfLoader: only glTF 2.0 is supported (" << path << ")" << std::endl;
+        return false;
+    }
+    const QJsonArray required = gltf.json.value("extensionsRequired").toArray();
+    if (!required.isEmpty()) {
+        // Compressed geometry (Draco, meshopt) and similar cannot be read as plain accessors
+        std::cerr << "GltfLoader: " << path << " requires unsupported extension "
+                  << required.at(0).toString().toStdString() << std::endl;
+        return false;
+    }
+    if (!loadBuffers(path, bin, bin_size, gltf)) {
+        return false;
+    }
+
+    // --- Geometry ---
+    const QJsonArray meshes = gltf.json.value("meshes").toArray();
+    AttributeState state;
+    for (const MeshInstance& instance : sceneInstances(gltf.json)) {
+        if (instance.mesh < 0 || instance.mesh >= meshes.size()) {
+            continue;
+        }
+        const QJsonArray primitives = meshes.at(instance.mesh).toObject().value("primitives").toArray();
+        for (int i = 0; i < primitives.size(); ++i) {
+            if (!appendPrimitive(gltf, primitives.at(i).toObject(), instance.transform, options, mesh, state)) {
+                std::cerr << "GltfLoader: failed to read mesh " << instance.mesh << " in " << path << std::endl;
+                return false;
+            }
+        }
+    }
+    if (state.skipped_primitives > 0) {
+        std::cerr << "GltfLoader: skipped " << state.skipped_primitives << " point/line primitives in " << path << std::endl;
+    }
+
+    // Per-vertex attributes share the position indices
+    if (!mesh.uvs.empty()) {
+        mesh.uvs.resize(mesh.vertices.size());
+        mesh.uv_indices = mesh.vertex_indices;
+    }
+    // Partial normals are dropped so Mesh::ensureNormals regenerates all of them
+    if (!mesh.normals.empty() && !state.normals_incomplete) {
+        mesh.normal_indices = mesh.vertex_indices;
+    } else {
+        mesh.normals.clear();
+    }
+
+    return true;
+}
@@ -0,0 +1,19 @@
+#ifndef GLTFLOADER_H
+#define GLTFLOADER_H
+
+#include "Mesh.h"
+#include "ObjLoader.h"
+#include <string>
+
+// glTF 2.0 reader for binary .glb files and .gltf files with embedded
+// (data URI) or external buffers. All triangle primitives of the default scene
+// are merged into one mesh with node transforms applied; accessor data is
+// copied straight out of the mapped buffer when its layout already matches.
+class GltfLoader
+{
+public:
+    static bool load(const std::string& path, Mesh& mesh, const MeshLoadOptions& options = MeshLoadOptions());
+    static bool isGlb(const char* data, size_t size);
+};
+
+#endif // GLTFLOADER_H
@@ -3,6 +3,10 @@
 #include "ObjLoader.h"
 #include "MeshChecker.h"
 #include "Logger.h"
+#include "MeshCache.h"
+#include "MeshLoader.h"
+#include "WorkerArena.h"
+#include "TaskScheduler.h"
 #include <QTabWidget>
 #include <QVBoxLayout>
 #include <QWidget>
@@ -24,6 +28,31 @@
 #include <QTextEdit>
 #include <QSpinBox>
 #include <QSlider>
+#include <QStandardPaths>
+#include <QPointer>
+
+static QStringList meshNameFilters()
+{
+    QStringList filters;
+    for (const auto& filter : MeshLoader::nameFilters()) {
+        filters.append(QString::fromStdString(filter));
+    }
+    return filters;
+}
+
+// Runs job as a task on the shared scheduler and blocks until it is done.
+// Batch jobs go through QtConcurrent for progress and cancellation, but its
+// pool threads only wait here, so the work itself is bounded by the
+// scheduler's thread count.
+template <typename Job>
+static auto runOnScheduler(const Job& job) -> decltype(job())
+{
+    decltype(job()) result;
+    TaskGroup group;
+    group.run([&]() { result = job(); });
+    group.wait();
+    return result;
+}
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -37,6 +66,9 @@ MainWindow::MainWindow(QWidget *parent)
     connect(&batchIntersectionWatcher, &QFutureWatcher<BatchIntersectionResult>::finished, this, &MainWindow::onBatchIntersectionFinished);
     connect(&Logger::getInstance(), &Logger::messageLogged, this, &MainWindow::onLogMessage);
     Logger::getInstance().init("mesh_checker.log");
+
+    QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/meshcache";
+    MeshCache::getInstance().init(cacheDir.toStdString(), 4096ull << 20);
 }
 
 MainWindow::~MainWindow()
@@ -153,6 +185,10 @@ void MainWindow::setupUI()
     showOverlappingUvsCheck->setChecked(false);
     singleCheckLayout->addWidget(showOverlappingUvsCheck);
 
+    showDegenerateCheck = new QCheckBox("Show Degenerate Faces");
+    showDegenerateCheck->setChecked(false);
+    singleCheckLayout->addWidget(showDegenerateCheck);
+
     highlightRadiusLabel = new QLabel("Highlight Radius: 0.01");
     singleCheckLayout->addWidget(highlightRadiusLabel);
     highlightRadiusSlider = new QSlider(Qt::Horizontal);
@@ -167,6 +203,7 @@ void MainWindow::setupUI()
     connect(showHolesCheck, &QCheckBox::toggled, this, &MainWindow::onVisualizationToggled);
     connect(showHolesCheck, &QCheckBox::toggled, this, &MainWindow::onVisualizationToggled);
     connect(showOverlappingUvsCheck, &QCheckBox::toggled, this, &MainWindow::onVisualizationToggled);
+    connect(showDegenerateCheck, &QCheckBox::toggled, this, &MainWindow::onVisualizationToggled);
     connect(highlightRadiusSlider, &QSlider::valueChanged, this, &MainWindow::onHighlightRadiusChanged);
 
     singleCheckLayout->addStretch();
@@ -182,8 +219,8 @@ void MainWindow::setupUI()
     batchCheckLayout->addWidget(selectFolderButton);
 
     batchResultsTable = new QTableWidget;
-    batchResultsTable->setColumnCount(9);
-    batchResultsTable->setHorizontalHeaderLabels({ "File", "Watertight", "Non-Manifold", "Self-Intersections", "Holes", "Degenerate", "Has UVs", "Overlapping UVs", "UVs Out of Bounds" });
+    batchResultsTable->setColumnCount(10);
+    batchResultsTable->setHorizontalHeaderLabels({ "File", "Watertight", "Non-Manifold", "Self-Intersections", "Holes", "Degenerate", "Has UVs", "Overlapping UVs", "UVs Out of Bounds", "Timed Out" });
     batchResultsTable->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
     batchCheckLayout->addWidget(batchResultsTable);
 
@@ -211,6 +248,15 @@ void MainWindow::setupUI()
     batchCheckUVBoundsCheck = new QCheckBox("UVs out of bounds");
     batchCheckUVBoundsCheck->setChecked(true);
     batchChecksLayout->addWidget(batchCheckUVBoundsCheck);
+    // A pathological file gives up on its slow check instead of holding a
+    // worker for the rest of the batch
+    QHBoxLayout *timeBudgetLayout = new QHBoxLayout;
+    timeBudgetLayout->addWidget(new QLabel("Time limit per check (s, 0 = none):"));
+    batchTimeBudgetSpinBox = new QSpinBox;
+    batchTimeBudgetSpinBox->setRange(0, 24 * 3600);
+    batchTimeBudgetSpinBox->setValue(0);
+    timeBudgetLayout->addWidget(batchTimeBudgetSpinBox);
+    batchChecksLayout->addLayout(timeBudgetLayout);
     batchChecksGroup->setLayout(batchChecksLayout);
     batchCheckLayout->addWidget(batchChecksGroup);
 
@@ -341,18 +387,22 @@ void MainWindow::onLoadMesh()
     viewerWidget->clearMeshes();
     // 2. Clear the results from the last check
     lastCheckResult.clear();
-    // 3. Clear the mesh object itself
-    currentMesh = Mesh();
+    // 3. Release the mesh; a check still running keeps its own handle
+    currentMesh.reset();
+    currentMeshColors.clear();
 
-    if (ObjLoader::load_indexed(filePath.toStdString(), currentMesh)) {
+    Mesh mesh;
+    if (ObjLoader::load_indexed(filePath.toStdString(), mesh)) {
         currentMeshPath = filePath;
         fileNameLabel->setText(QFileInfo(filePath).fileName());
         
-        // 4. Ensure the mesh has default colors before rendering
-        currentMesh.colors.assign(currentMesh.vertices.size(), glm::vec3(0.7f, 0.7f, 0.7f));
+        // 4. Ensure the mesh has normals and default colors before rendering
+        mesh.ensureNormals();
+        currentMesh = makeMeshHandle(std::move(mesh));
+        currentMeshColors.assign(currentMesh->vertices.size(), glm::vec3(0.7f, 0.7f, 0.7f));
         
         // 5. Send the clean mesh to the viewer
-        viewerWidget->setMeshes({&currentMesh}, &lastCheckResult, nullptr);
+        viewerWidget->setMeshes({{currentMesh, &currentMeshColors}}, &lastCheckResult, nullptr);
         viewerWidget->focusOnMesh();
         Logger::getInstance().log("Mesh loaded successfully.");
     } else {
@@ -363,7 +413,7 @@ void MainWindow::onLoadMesh()
 
 void MainWindow::onCheckMesh()
 {
-    if (currentMesh.vertices.empty()) {
+    if (!currentMesh || currentMesh->vertices.empty()) {
         QMessageBox::warning(this, "Warning", "No mesh loaded.");
         return;
     }
@@ -379,10 +429,32 @@ void MainWindow::onCheckMesh()
     if (checkUVOverlapCheck->isChecked()) checksToPerform.insert(MeshChecker::CheckType::UVOverlap);
     if (checkUVBoundsCheck->isChecked()) checksToPerform.insert(MeshChecker::CheckType::UVBounds);
 
-    progressDialog = new QProgressDialog("Checking mesh...", "Cancel", 0, 0, this);
+    progressDialog = new QProgressDialog("Checking mesh...", "Cancel", 0, 1000, this);
     progressDialog->setWindowModality(Qt::WindowModal);
-    
-    QFuture<MeshChecker::CheckResult> future = QtConcurrent::run(&MeshChecker::check, currentMesh, checksToPerform);
+
+    // Cancel asks the running checks to stop; the partial result still
+    // arrives through the watcher
+    checkCancel = std::make_shared<std::atomic<bool>>(false);
+    connect(progressDialog, &QProgressDialog::canceled, this, [cancel = checkCancel]() { cancel->store(true); });
+
+    // Progress comes from the checking threads and is posted to the dialog
+    MeshCheckOptions options;
+    QPointer<QProgressDialog> dialog = progressDialog;
+    options.progress = [this, dialog](const std::string& phase, float fraction) {
+        QMetaObject::invokeMethod(this, [dialog, label = QString::fromStdString(phase), fraction]() {
+            if (dialog && !dialog->wasCanceled()) {
+                dialog->setLabelText(QString("Checking mesh: %1...").arg(label));
+                dialog->setValue(static_cast<int>(fraction * 1000.0f));
+            }
+        }, Qt::QueuedConnection);
+    };
+
+    // The task shares the mesh through its handle instead of copying it
+    MeshHandle mesh = currentMesh;
+    QFuture<MeshChecker::CheckResult> future = QtConcurrent::run([mesh, checksToPerform, options, cancel = checkCancel]() mutable {
+        options.cancel = cancel.get();
+        return MeshChecker::check(*mesh, checksToPerform, options);
+    });
     checkWatcher.setFuture(future);
     
     connect(&checkWatcher, &QFutureWatcher<MeshChecker::CheckResult>::finished, progressDialog, &QProgressDialog::reset);
@@ -395,22 +467,37 @@ void MainWindow::onCheckFinished()
     progressDialog->hide();
     lastCheckResult = checkWatcher.result();
 
-    Logger::getInstance().log("Mesh check finished.");
+    Logger::getInstance().log(lastCheckResult.cancelled ? "Mesh check cancelled, results are partial." : "Mesh check finished.");
 
-    watertightResultLabel->setText(QString("Watertight: %1").arg(lastCheckResult.is_watertight ? "Yes" : "No"));
-    nonManifoldResultLabel->setText(QString("Non-manifold vertices: %1").arg(lastCheckResult.non_manifold_vertices_count));
-    selfIntersectionResultLabel->setText(QString("Self-intersections: %1").arg(lastCheckResult.self_intersections_count));
-    holesResultLabel->setText(QString("Holes: %1").arg(lastCheckResult.holes_count));
-    degenerateFacesResultLabel->setText(QString("Degenerate faces: %1").arg(lastCheckResult.degenerate_faces_count));
-    hasUvsResultLabel->setText(QString("Has UVs: %1").arg(lastCheckResult.has_uvs ? "Yes" : "No"));
-    overlappingUvsResultLabel->setText(QString("Overlapping UVs: %1").arg(lastCheckResult.overlapping_uv_islands_count));
-    uvsOutOfBoundsResultLabel->setText(QString("UVs out of bounds: %1").arg(lastCheckResult.uvs_out_of_bounds_count));
+    // After a cancel, checks that did not finish show no value
+    using CheckType = MeshChecker::CheckType;
+    auto value = [this](std::initializer_list<CheckType> checks, const QString& text) {
+        if (!lastCheckResult.cancelled) {
+            return text;
+        }
+        for (CheckType check : checks) {
+            if (lastCheckResult.completed_checks.count(check)) {
+                return text;
+            }
+        }
+        return QString("(cancelled)");
+    };
+    watertightResultLabel->setText(QString("Watertight: %1").arg(value({CheckType::Watertight}, lastCheckResult.is_watertight ? "Yes" : "No")));
+    nonManifoldResultLabel->setText(QString("Non-manifold vertices: %1").arg(value({CheckType::NonManifold}, QString::number(lastCheckResult.non_manifold_vertices_count))));
+    selfIntersectionResultLabel->setText(QString("Self-intersections: %1").arg(value({CheckType::SelfIntersect}, QString::number(lastCheckResult.self_intersections_count))));
+    holesResultLabel->setText(QString("Holes: %1").arg(value({CheckType::Holes}, QString::number(lastCheckResult.holes_count))));
+    degenerateFacesResultLabel->setText(QString("Degenerate faces: %1").arg(value({CheckType::DegenerateFaces}, QString::number(lastCheckResult.degenerate_faces_count))));
+    hasUvsResultLabel->setText(QString("Has UVs: %1").arg(value({CheckType::UVOverlap, CheckType::UVBounds}, lastCheckResult.has_uvs ? "Yes" : "No")));
+    overlappingUvsResultLabel->setText(QString("Overlapping UVs: %1").arg(value({CheckType::UVOverlap}, QString::number(lastCheckResult.overlapping_uv_islands_count))));
+    uvsOutOfBoundsResultLabel->setText(QString("UVs out of bounds: %1").arg(value({CheckType::UVBounds}, QString::number(lastCheckResult.uvs_out_of_bounds_count))));
 
     bool showSlider = lastCheckResult.intersecting_faces.size() < 20000 || lastCheckResult.non_manifold_faces.size() < 20000;
     highlightRadiusLabel->setVisible(showSlider);
     highlightRadiusSlider->setVisible(showSlider);
 
-    currentMesh.colors.assign(currentMesh.vertices.size(), glm::vec3(0.7f, 0.7f, 0.7f)); // Reset to default color
+    if (currentMesh) {
+        currentMeshColors.assign(currentMesh->vertices.size(), glm::vec3(0.7f, 0.7f, 0.7f)); // Reset to default color
+    }
     onVisualizationToggled();
 }
 
@@ -425,43 +512,45 @@ void MainWindow::onSelectFolder()
 
     batchResultsTable->setRowCount(0);
 
-    QDirIterator it(dirPath, {"*.obj"}, QDir::Files, QDirIterator::Subdirectories);
+    QDirIterator it(dirPath, meshNameFilters(), QDir::Files, QDirIterator::Subdirectories);
     QStringList files;
     while(it.hasNext()){
         files.append(it.next());
     }
 
-    auto processFile = [this](const QString& filePath) -> BatchCheckResult {
+    std::set<MeshChecker::CheckType> checksToPerform;
+    if (batchCheckWatertightCheck->isChecked()) checksToPerform.insert(MeshChecker::CheckType::Watertight);
+    if (batchCheckNonManifoldCheck->isChecked()) checksToPerform.insert(MeshChecker::CheckType::NonManifold);
+    if (batchCheckSelfIntersectCheck->isChecked()) checksToPerform.insert(MeshChecker::CheckType::SelfIntersect);
+    if (batchCheckHolesCheck->isChecked()) checksToPerform.insert(MeshChecker::CheckType::Holes);
+    if (batchCheckDegenerateFacesCheck->isChecked()) checksToPerform.insert(MeshChecker::CheckType::DegenerateFaces);
+    if (batchCheckUVOverlapCheck->isChecked()) checksToPerform.insert(MeshChecker::CheckType::UVOverlap);
+    if (batchCheckUVBoundsCheck->isChecked()) checksToPerform.insert(MeshChecker::CheckType::UVBounds);
+    MeshLoadOptions loadOptions = MeshChecker::requiredAttributes(checksToPerform);
+
+    // Cancelling also stops the files being checked, not only the ones queued
+    batchCancel = std::make_shared<std::atomic<bool>>(false);
+    const std::chrono::milliseconds timeBudget(batchTimeBudgetSpinBox->value() * 1000ll);
+    auto processFile = [checksToPerform, loadOptions, timeBudget, cancel = batchCancel](const QString& filePath) -> BatchCheckResult {
         Logger::getInstance().log("Checking file: " + filePath.toStdString());
-        
-        Mesh mesh;
-        if (ObjLoader::load_indexed(filePath.toStdString(), mesh)) {
-            std::set<MeshChecker::CheckType> checksToPerform;
-            if (batchCheckWatertightCheck->isChecked()) checksToPerform.insert(MeshChecker::CheckType::Watertight);
-            if (batchCheckNonManifoldCheck->isChecked()) checksToPerform.insert(MeshChecker::CheckType::NonManifold);
-            if (batchCheckSelfIntersectCheck->isChecked()) checksToPerform.insert(MeshChecker::CheckType::SelfIntersect);
-            if (batchCheckHolesCheck->isChecked()) checksToPerform.insert(MeshChecker::CheckType::Holes);
-            if (batchCheckDegenerateFacesCheck->isChecked()) checksToPerform.insert(MeshChecker::CheckType::DegenerateFaces);
-            if (batchCheckUVOverlapCheck->isChecked()) checksToPerform.insert(MeshChecker::CheckType::UVOverlap);
-            if (batchCheckUVBoundsCheck->isChecked()) checksToPerform.insert(MeshChecker::CheckType::UVBounds);
-
-            MeshChecker::CheckResult result = MeshChecker::check(mesh, checksToPerform);
-            
-            // Explicitly clear mesh data to release memory
-            mesh.vertices.clear();
-            mesh.vertices.shrink_to_fit();
-            mesh.uvs.clear();
-            mesh.uvs.shrink_to_fit();
-            mesh.colors.clear();
-            mesh.colors.shrink_to_fit();
-            mesh.normals.clear();
-            mesh.normals.shrink_to_fit();
-            mesh.vertex_indices.clear();
-            mesh.vertex_indices.shrink_to_fit();
-            mesh.uv_indices.clear();
-            mesh.uv_indices.shrink_to_fit();
-            mesh.normal_indices.clear();
-            mesh.normal_indices.shrink_to_fit();
+
+        // One arena per scheduler thread, reused by every file that thread
+        // checks. A thread waiting inside a check only runs that check's
+        // tasks, so it never starts a second file on the same arena.
+        static thread_local WorkerArena arena;
+        arena.reset();
+        MeshCheckOptions checkOptions;
+        checkOptions.arena = &arena;
+        checkOptions.cancel = cancel.get();
+        checkOptions.check_time_budget = timeBudget;
+
+        MeshLoadOptions workerLoadOptions = loadOptions;
+        workerLoadOptions.arena = &arena;
+
+        Mesh& mesh = arena.mesh;
+        if (MeshLoader::load(filePath.toStdString(), mesh, workerLoadOptions)) {
+            MeshChecker::CheckResult result = MeshChecker::check(mesh, checksToPerform, checkOptions);
+            arena.reset();
 
             return {filePath, result};
         } else {
@@ -474,9 +563,16 @@ void MainWindow::onSelectFolder()
     if (!batchDisableParallelCheck->isChecked()) {
         numThreads = batchAutoThreadsCheck->isChecked() ? QThread::idealThreadCount() : batchThreadsSpinBox->value();
     }
+    // Resizing waits for running work, so the scheduler is only resized when
+    // idle; otherwise the thread pool alone limits how many files run at once
+    if (!TaskScheduler::getInstance().trySetThreadCount(numThreads)) {
+        Logger::getInstance().log("Scheduler busy, keeping its current thread count for this batch");
+    }
     QThreadPool::globalInstance()->setMaxThreadCount(numThreads);
 
-    QFuture<BatchCheckResult> future = QtConcurrent::mapped(files, processFile);
+    QFuture<BatchCheckResult> future = QtConcurrent::mapped(files, [processFile](const QString& filePath) {
+        return runOnScheduler([&]() { return processFile(filePath); });
+    });
     batchCheckWatcher.setFuture(future);
 
     progressDialog = new QProgressDialog("Checking files in folder...", "Cancel", 0, files.count(), this);
@@ -486,6 +582,7 @@ void MainWindow::onSelectFolder()
     connect(&batchCheckWatcher, &QFutureWatcher<BatchCheckResult>::progressValueChanged, progressDialog, &QProgressDialog::setValue);
     connect(&batchCheckWatcher, &QFutureWatcher<BatchCheckResult>::finished, progressDialog, &QProgressDialog::reset);
     connect(progressDialog, &QProgressDialog::canceled, &batchCheckWatcher, &QFutureWatcher<BatchCheckResult>::cancel);
+    connect(progressDialog, &QProgressDialog::canceled, this, [cancel = batchCancel]() { cancel->store(true); });
     
     progressDialog->exec();
 }
@@ -505,6 +602,11 @@ void MainWindow::onBatchResultReady(int index)
     batchResultsTable->setItem(row, 6, new QTableWidgetItem(result.checkResult.has_uvs ? "Yes" : "No"));
     batchResultsTable->setItem(row, 7, new QTableWidgetItem(QString::number(result.checkResult.overlapping_uv_islands_count)));
     batchResultsTable->setItem(row, 8, new QTableWidgetItem(QString::number(result.checkResult.uvs_out_of_bounds_count)));
+    QStringList timedOut;
+    for (MeshChecker::CheckType check : result.checkResult.timed_out_checks) {
+        timedOut.append(MeshChecker::checkName(check));
+    }
+    batchResultsTable->setItem(row, 9, new QTableWidgetItem(timedOut.join(';')));
 }
 
 void MainWindow::onBatchCheckFinished()
@@ -518,13 +620,18 @@ void MainWindow::onBatchCheckFinished()
 
 void MainWindow::onLoadMannequinForBatchIntersection()
 {
-    QString filePath = QFileDialog::getOpenFileName(this, "Load Mannequin", "", "OBJ Files (*.obj)");
+    QString filePath = QFileDialog::getOpenFileName(this, "Load Mannequin", "", "Mesh Files (" + meshNameFilters().join(' ') + ")");
     if (!filePath.isEmpty()) {
         Logger::getInstance().log("Loading mannequin for batch intersection: " + filePath.toStdString());
-        if (!ObjLoader::load_indexed(filePath.toStdString(), batchIntersectionMannequin)) {
+        MeshLoadOptions loadOptions;
+        loadOptions.keep_uvs = false;
+        loadOptions.keep_normals = false;
+        Mesh mesh;
+        if (!MeshLoader::load(filePath.toStdString(), mesh, loadOptions)) {
             QMessageBox::critical(this, "Error", "Failed to load mannequin mesh.");
             Logger::getInstance().log("Failed to load mannequin for batch intersection.");
         } else {
+            batchIntersectionMannequin = makeMeshHandle(std::move(mesh));
             Logger::getInstance().log("Mannequin for batch intersection loaded successfully.");
         }
     }
@@ -532,7 +639,7 @@ void MainWindow::onLoadMannequinForBatchIntersection()
 
 void MainWindow::onSelectApparelFolder()
 {
-    if (batchIntersectionMannequin.vertices.empty()) {
+    if (!batchIntersectionMannequin || batchIntersectionMannequin->vertices.empty()) {
         QMessageBox::warning(this, "Warning", "Please load a mannequin first.");
         return;
     }
@@ -546,22 +653,28 @@ void MainWindow::onSelectApparelFolder()
 
     batchIntersectionResultsTable->setRowCount(0);
 
-    QDirIterator it(dirPath, {"*.obj"}, QDir::Files, QDirIterator::Subdirectories);
+    QDirIterator it(dirPath, meshNameFilters(), QDir::Files, QDirIterator::Subdirectories);
     QStringList files;
     while(it.hasNext()){
         files.append(it.next());
     }
 
-    auto processFile = [this](const QString& filePath) -> BatchIntersectionResult {
+    // The intersection test only reads positions and vertex indices
+    MeshLoadOptions loadOptions;
+    loadOptions.keep_uvs = false;
+    loadOptions.keep_normals = false;
+
+    MeshHandle mannequin = batchIntersectionMannequin;
+    auto processFile = [mannequin, loadOptions](const QString& filePath) -> BatchIntersectionResult {
         Logger::getInstance().log("Checking file for intersection: " + filePath.toStdString());
         
         Mesh apparelMesh;
-        if (ObjLoader::load_indexed(filePath.toStdString(), apparelMesh)) {
+        if (MeshLoader::load(filePath.toStdString(), apparelMesh, loadOptions)) {
             std::vector<int> intersecting_faces;
-            MeshChecker::intersects(batchIntersectionMannequin, apparelMesh, intersecting_faces);
+            MeshChecker::intersects(*mannequin, apparelMesh, intersecting_faces);
 
             // Bounding box check
-            auto mannequinBox = batchIntersectionMannequin.getBoundingBox();
+            auto mannequinBox = mannequin->getBoundingBox();
             auto apparelBox = apparelMesh.getBoundingBox();
 
             glm::vec3 mannequinSize = mannequinBox.max - mannequinBox.min;
@@ -602,9 +715,16 @@ void MainWindow::onSelectApparelFolder()
     if (!batchDisableParallelCheck->isChecked()) {
         numThreads = batchAutoThreadsCheck->isChecked() ? QThread::idealThreadCount() : batchThreadsSpinBox->value();
     }
+    // Resizing waits for running work, so the scheduler is only resized when
+    // idle; otherwise the thread pool alone limits how many files run at once
+    if (!TaskScheduler::getInstance().trySetThreadCount(numThreads)) {
+        Logger::getInstance().log("Scheduler busy, keeping its current thread count for this batch");
+    }
     QThreadPool::globalInstance()->setMaxThreadCount(numThreads);
 
-    QFuture<BatchIntersectionResult> future = QtConcurrent::mapped(files, processFile);
+    QFuture<BatchIntersectionResult> future = QtConcurrent::mapped(files, [processFile](const QString& filePath) {
+        return runOnScheduler([&]() { return processFile(filePath); });
+    });
     batchIntersectionWatcher.setFuture(future);
 
     progressDialog = new QProgressDialog("Checking intersections in folder...", "Cancel", 0, files.count(), this);
@@ -704,12 +824,14 @@ void MainWindow::onLoadMannequin()
     QString filePath = QFileDialog::getOpenFileName(this, "Load Mannequin", "", "OBJ Files (*.obj)");
     if (!filePath.isEmpty()) {
         Logger::getInstance().log("Loading mannequin: " + filePath.toStdString());
-        if (!ObjLoader::load_indexed(filePath.toStdString(), mannequinMesh)) {
+        Mesh mesh;
+        if (!ObjLoader::load_indexed(filePath.toStdString(), mesh)) {
             QMessageBox::critical(this, "Error", "Failed to load mannequin mesh.");
             Logger::getInstance().log("Failed to load mannequin.");
         } else {
             Logger::getInstance().log("Mannequin loaded successfully.");
-            mannequinMesh.colors.assign(mannequinMesh.vertices.size(), glm::vec3(0.7f, 0.7f, 0.7f));
+            mesh.ensureNormals();
+            mannequinMesh = makeMeshHandle(std::move(mesh));
             updateIntersectionView();
         }
     }
@@ -727,8 +849,8 @@ void MainWindow::onLoadApparel()
     for (const QString& filePath : filePaths) {
         Mesh mesh;
         if (ObjLoader::load_indexed(filePath.toStdString(), mesh)) {
-            mesh.colors.assign(mesh.vertices.size(), glm::vec3(0.7f, 0.7f, 0.7f));
-            apparelMeshes.push_back(mesh);
+            mesh.ensureNormals();
+            apparelMeshes.push_back(makeMeshHandle(std::move(mesh)));
             Logger::getInstance().log("Loaded apparel item: " + filePath.toStdString());
         } else {
             Logger::getInstance().log("Failed to load apparel item: " + filePath.toStdString());
@@ -744,18 +866,19 @@ void MainWindow::updateCameraStatus(const QString& status)
 
 void MainWindow::onCheckIntersection()
 {
-    if (mannequinMesh.vertices.empty() || apparelMeshes.empty()) {
+    if (!mannequinMesh || mannequinMesh->vertices.empty() || apparelMeshes.empty()) {
         QMessageBox::warning(this, "Warning", "Please load both a mannequin and at least one apparel item.");
         return;
     }
 
     Logger::getInstance().log("Starting intersection check...");
 
-    auto checkFunc = [this]() {
+    // Share the meshes with the task; loading new ones meanwhile is safe
+    auto checkFunc = [mannequin = mannequinMesh, apparel = apparelMeshes]() {
         std::vector<IntersectionResult> results;
-        for (size_t i = 0; i < apparelMeshes.size(); ++i) {
+        for (size_t i = 0; i < apparel.size(); ++i) {
             IntersectionResult result;
-            result.intersects = MeshChecker::intersects(mannequinMesh, apparelMeshes[i], result.intersecting_faces);
+            result.intersects = MeshChecker::intersects(*mannequin, *apparel[i], result.intersecting_faces);
             results.push_back(result);
         }
         return results;
@@ -809,31 +932,32 @@ void MainWindow::onHighlightRadiusChanged(int value)
 void MainWindow::updateIntersectionView()
 {
     // Reset colors
-    if (!mannequinMesh.vertices.empty()) {
-        mannequinMesh.colors.assign(mannequinMesh.vertices.size(), glm::vec3(0.7f, 0.7f, 0.7f));
+    if (mannequinMesh) {
+        mannequinColors.assign(mannequinMesh->vertices.size(), glm::vec3(0.7f, 0.7f, 0.7f));
     }
-    for (auto& apparelMesh : apparelMeshes) {
-        apparelMesh.colors.assign(apparelMesh.vertices.size(), glm::vec3(0.7f, 0.7f, 0.7f));
+    apparelColors.resize(apparelMeshes.size());
+    for (size_t i = 0; i < apparelMeshes.size(); ++i) {
+        apparelColors[i].assign(apparelMeshes[i]->vertices.size(), glm::vec3(0.7f, 0.7f, 0.7f));
     }
 
-    std::vector<const Mesh*> meshes;
-    if (showMannequinCheck->isChecked() && !mannequinMesh.vertices.empty()) {
-        meshes.push_back(&mannequinMesh);
+    std::vector<MeshView> meshes;
+    if (showMannequinCheck->isChecked() && mannequinMesh && !mannequinMesh->vertices.empty()) {
+        meshes.push_back({mannequinMesh, &mannequinColors});
     }
     if (showApparelCheck->isChecked()) {
-        for (const auto& apparelMesh : apparelMeshes) {
-            meshes.push_back(&apparelMesh);
+        for (size_t i = 0; i < apparelMeshes.size(); ++i) {
+            meshes.push_back({apparelMeshes[i], &apparelColors[i]});
         }
     }
 
     if (showIntersectionsCheck_IntersectionTab->isChecked()) {
         for (size_t i = 0; i < intersectionResults.size(); ++i) {
-            if (i < intersectionResults.size() && intersectionResults[i].intersects) {
+            if (i < apparelMeshes.size() && intersectionResults[i].intersects) {
                 for (const auto& face_idx : intersectionResults[i].intersecting_faces) {
                     for (int j = 0; j < 3; ++j) {
-                        unsigned int vertex_index = apparelMeshes[i].vertex_indices[face_idx * 3 + j];
-                        if (vertex_index < apparelMeshes[i].colors.size()) {
-                           apparelMeshes[i].colors[vertex_index] = glm::vec3(1.0f, 0.0f, 0.0f); // Red
+                        unsigned int vertex_index = apparelMeshes[i]->vertex_indices[face_idx * 3 + j];
+                        if (vertex_index < apparelColors[i].size()) {
+                           apparelColors[i][vertex_index] = glm::vec3(1.0f, 0.0f, 0.0f); // Red
                         }
                     }
                 }
@@ -848,9 +972,10 @@ void MainWindow::updateIntersectionView()
 
 void MainWindow::onVisualizationToggled()
 {
-    if (currentMesh.vertices.empty()) return;
+    if (!currentMesh || currentMesh->vertices.empty()) return;
 
-    currentMesh.colors.assign(currentMesh.vertices.size(), glm::vec3(0.7f, 0.7f, 0.7f)); // Default color
+    const Mesh& mesh = *currentMesh;
+    currentMeshColors.assign(mesh.vertices.size(), glm::vec3(0.7f, 0.7f, 0.7f)); // Default color
     viewerWidget->highlight_vertices.clear();
 
     bool useSpheres = (lastCheckResult.intersecting_faces.size() < 20000 && !lastCheckResult.intersecting_faces.empty()) || 
@@ -860,13 +985,13 @@ void MainWindow::onVisualizationToggled()
         if (useSpheres) {
             for (const auto& face_idx : lastCheckResult.intersecting_faces) {
                 for (int i = 0; i < 3; ++i) {
-                    viewerWidget->highlight_vertices.push_back(currentMesh.vertices[currentMesh.vertex_indices[face_idx * 3 + i]]);
+                    viewerWidget->highlight_vertices.push_back(mesh.vertices[mesh.vertex_indices[face_idx * 3 + i]]);
                 }
             }
         }
         for (const auto& face_idx : lastCheckResult.intersecting_faces) {
             for (int i = 0; i < 3; ++i) {
-                currentMesh.colors[currentMesh.vertex_indices[face_idx * 3 + i]] = glm::vec3(1.0f, 0.0f, 0.0f);
+                currentMeshColors[mesh.vertex_indices[face_idx * 3 + i]] = glm::vec3(1.0f, 0.0f, 0.0f);
             }
         }
     }
@@ -875,13 +1000,13 @@ void MainWindow::onVisualizationToggled()
         if (useSpheres) {
             for (const auto& face_idx : lastCheckResult.non_manifold_faces) {
                 for (int i = 0; i < 3; ++i) {
-                    viewerWidget->highlight_vertices.push_back(currentMesh.vertices[currentMesh.vertex_indices[face_idx * 3 + i]]);
+                    viewerWidget->highlight_vertices.push_back(mesh.vertices[mesh.vertex_indices[face_idx * 3 + i]]);
                 }
             }
         }
         for (const auto& face_idx : lastCheckResult.non_manifold_faces) {
             for (int i = 0; i < 3; ++i) {
-                currentMesh.colors[currentMesh.vertex_indices[face_idx * 3 + i]] = glm::vec3(1.0f, 1.0f, 0.0f);
+                currentMeshColors[mesh.vertex_indices[face_idx * 3 + i]] = glm::vec3(1.0f, 1.0f, 0.0f);
             }
         }
     }
@@ -893,12 +1018,28 @@ void MainWindow::onVisualizationToggled()
     if (showOverlappingUvsCheck->isChecked()) {
         for (const auto& face_idx : lastCheckResult.overlapping_uv_faces) {
             for (int i = 0; i < 3; ++i) {
-                currentMesh.colors[currentMesh.vertex_indices[face_idx * 3 + i]] = glm::vec3(1.0f, 0.0f, 1.0f);
+                currentMeshColors[mesh.vertex_indices[face_idx * 3 + i]] = glm::vec3(1.0f, 0.0f, 1.0f);
+            }
+        }
+    }
+
+    if (showDegenerateCheck->isChecked()) {
+        // Degenerate faces have next to no area, so mark their corners too
+        if (lastCheckResult.degenerate_faces.size() < 20000) {
+            for (const auto& face_idx : lastCheckResult.degenerate_faces) {
+                for (int i = 0; i < 3; ++i) {
+                    viewerWidget->highlight_vertices.push_back(mesh.vertices[mesh.vertex_indices[face_idx * 3 + i]]);
+                }
+            }
+        }
+        for (const auto& face_idx : lastCheckResult.degenerate_faces) {
+            for (int i = 0; i < 3; ++i) {
+                currentMeshColors[mesh.vertex_indices[face_idx * 3 + i]] = glm::vec3(1.0f, 0.5f, 0.0f);
             }
         }
     }
 
-    viewerWidget->setMeshes({&currentMesh}, &lastCheckResult, nullptr);
+    viewerWidget->setMeshes({{currentMesh, &currentMeshColors}}, &lastCheckResult, nullptr);
 }
 
 void MainWindow::onCheckDegenerate()
@@ -4,8 +4,11 @@
 #include <QMainWindow>
 #include <QFutureWatcher>
 #include "Mesh.h"
+#include "MeshHandle.h"
 #include "MeshChecker.h"
 #include "IntersectionResult.h"
+#include <atomic>
+#include <memory>
 
 struct BatchCheckResult {
     QString filePath;
@@ -71,9 +74,13 @@ private:
     QTabWidget *tabWidget;
     ViewerWidget *viewerWidget;
     QTextEdit* console;
-    Mesh currentMesh;
-    Mesh mannequinMesh;
-    std::vector<Mesh> apparelMeshes;
+    MeshHandle currentMesh;
+    MeshHandle mannequinMesh;
+    std::vector<MeshHandle> apparelMeshes;
+    // Highlight colors drawn over the shared meshes, one per vertex
+    std::vector<glm::vec3> currentMeshColors;
+    std::vector<glm::vec3> mannequinColors;
+    std::vector<std::vector<glm::vec3>> apparelColors;
     QString currentMeshPath;
     MeshChecker::CheckResult lastCheckResult;
 
@@ -92,6 +99,7 @@ private:
     QCheckBox* showNonManifoldCheck;
     QCheckBox* showHolesCheck;
     QCheckBox* showOverlappingUvsCheck;
+    QCheckBox* showDegenerateCheck;
     QSlider* highlightRadiusSlider;
     QLabel* highlightRadiusLabel;
 
@@ -116,6 +124,7 @@ private:
     QCheckBox* batchAutoThreadsCheck;
     QSpinBox* batchThreadsSpinBox;
     QCheckBox* batchDisableParallelCheck;
+    QSpinBox* batchTimeBudgetSpinBox;
 
     // Intersection Check
     QListWidget* intersectionResultsList;
@@ -131,7 +140,7 @@ private:
 
     // Batch Intersection Check
     QTableWidget* batchIntersectionResultsTable;
-    Mesh batchIntersectionMannequin;
+    MeshHandle batchIntersectionMannequin;
 
     // Async
     QFutureWatcher<MeshChecker::CheckResult> checkWatcher;
@@ -139,6 +148,9 @@ private:
     QFutureWatcher<BatchCheckResult> batchCheckWatcher;
     QFutureWatcher<BatchIntersectionResult> batchIntersectionWatcher;
     QProgressDialog* progressDialog;
+    // Cancel tokens of the running check and batch, shared with their tasks
+    std::shared_ptr<std::atomic<bool>> checkCancel;
+    std::shared_ptr<std::atomic<bool>> batchCancel;
 };
 
 #endif // MAINWINDOW_H
@@ -0,0 +1,39 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Read-only memory mapping of a whole file or of a range of it.
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path);
+    // Maps at most 'length' bytes starting at 'offset', which must be a
+    // multiple of 64 KiB (the mapping granularity on Windows). The mapping
+    // is shorter if the file ends first.
+    bool openRange(const std::string& path, uint64_t offset, size_t length);
+    void close();
+
+    bool isOpen() const { return data_ != nullptr || (opened_ && size_ == 0); }
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    bool opened_ = false;
+#ifdef _WIN32
+    void* file_handle_ = nullptr;
+    void* mapping_handle_ = nullptr;
+#endif
+};
+
+#endif // MAPPEDFILE_H
@@ -0,0 +1,94 @@
+#include "Mesh.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Faces or vertices processed per task
+const size_t NORMAL_GRAIN = 1 << 14;
+
+// Unnormalized face normals; their length is twice the face area. The cross
+// product is written out per component so the loop body stays branch-free.
+void computeFaceNormals(const Mesh& mesh, size_t num_faces, std::vector<glm::vec3>& face_normals)
+{
+    face_normals.resize(num_faces);
+    const glm::vec3* positions = mesh.vertices.data();
+    const unsigned int* indices = mesh.vertex_indices.data();
+    glm::vec3* out = face_normals.data();
+    Parallel::forRange(num_faces, NORMAL_GRAIN, [&](size_t begin, size_t end) {
+        for (size_t f = begin; f < end; ++f) {
+            const glm::vec3& p0 = positions[indices[3 * f]];
+            const glm::vec3& p1 = positions[indices[3 * f + 1]];
+            const glm::vec3& p2 = positions[indices[3 * f + 2]];
+            const float ax = p1.x - p0.x, ay = p1.y - p0.y, az = p1.z - p0.z;
+            const float bx = p2.x - p0.x, by = p2.y - p0.y, bz = p2.z - p0.z;
+            out[f] = glm::vec3(ay * bz - az * by, az * bx - ax * bz, ax * by - ay * bx);
+        }
+    });
+}
+
+// Degenerate faces keep a zero normal instead of producing NaNs.
+inline glm::vec3 normalizeOrZero(const glm::vec3& n)
+{
+    const float length_sq = n.x * n.x + n.y * n.y + n.z * n.z;
+    return length_sq > 0.0f ? n / std::sqrt(length_sq) : n;
+}
+
+} // namespace
+
+void Mesh::computeNormals(NormalMode mode)
+{
+    const size_t num_faces = vertex_indices.size() / 3;
+    const size_t num_corners = num_faces * 3;
+    const size_t num_vertices = vertices.size();
+    for (size_t i = 0; i < num_corners; ++i) {
+        if (vertex_indices[i] >= num_vertices) {
+            normals.clear();
+            normal_indices.clear();
+            return;
+        }
+    }
+
+    std::vector<glm::vec3> face_normals;
+    computeFaceNormals(*this, num_faces, face_normals);
+    normal_indices.resize(num_corners);
+
+    if (mode == NormalMode::Flat) {
+        Parallel::forRange(num_faces, NORMAL_GRAIN, [&](size_t begin, size_t end) {
+            for (size_t f = begin; f < end; ++f) {
+                face_normals[f] = normalizeOrZero(face_normals[f]);
+                normal_indices[3 * f] = normal_indices[3 * f + 1] = normal_indices[3 * f + 2] = static_cast<unsigned int>(f);
+            }
+        });
+        normals = std::move(face_normals);
+        return;
+    }
+
+    // Smooth: list the faces around each vertex (compressed rows) so every
+    // vertex sums its own faces and no two threads write the same normal.
+    std::vector<unsigned int> offsets(num_vertices + 1, 0);
+    for (size_t i = 0; i < num_corners; ++i) {
+        ++offsets[vertex_indices[i] + 1];
+    }
+    for (size_t v = 0; v < num_vertices; ++v) {
+        offsets[v + 1] += offsets[v];
+    }
+    std::vector<unsigned int> vertex_faces(num_corners);
+    std::vector<unsigned int> cursor(offsets.begin(), offsets.end() - 1);
+    for (size_t i = 0; i < num_corners; ++i) {
+        vertex_faces[cursor[vertex_indices[i]]++] = static_cast<unsigned int>(i / 3);
+    }
+
+    normals.resize(num_vertices);
+    Parallel::forRange(num_vertices, NORMAL_GRAIN, [&](size_t begin, size_t end) {
+        for (size_t v = begin; v < end; ++v) {
+            glm::vec3 sum(0.0f, 0.0f, 0.0f);
+            for (unsigned int k = offsets[v]; k < offsets[v + 1]; ++k) {
+                sum += face_normals[vertex_faces[k]];
+            }
+            normals[v] = normalizeOrZero(sum);
+        }
+    });
+    std::copy(vertex_indices.begin(), vertex_indices.begin() + num_corners, normal_indices.begin());
+}
@@ -39,6 +39,22 @@ struct Mesh
         }
         return box;
     }
+
+    enum class NormalMode {
+        Flat,   // One normal per face
+        Smooth  // Area-weighted normal per position, indexed like the positions
+    };
+
+    // Loaders leave normals empty when the file has none; whoever needs them
+    // (the viewer) asks here. Normals that are already present are kept.
+    void ensureNormals(NormalMode mode = NormalMode::Smooth) {
+        if (normals.empty() || normal_indices.size() != vertex_indices.size()) {
+            computeNormals(mode);
+        }
+    }
+
+    // Replaces normals and normal_indices. Parallel over faces and vertices.
+    void computeNormals(NormalMode mode);
 };
 
 #endif // MESH_H
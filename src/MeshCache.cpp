@@ -0,0 +1,322 @@
+#include "MeshCache.h"
+#include "Hash.h"
+#include "MappedFile.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const char CACHE_MAGIC[8] = {'M', 'S', 'H', 'C', 'A', 'C', 'H', 'E'};
+// Bump whenever the loaders change what a cached mesh holds for the same
+// file and variant, so older entries are reloaded instead of trusted.
+// 2: normals only stored when requested, parser backend in the variant
+// 3: out-of-range relative texcoord and normal indices rejected
+// 4: texcoord and normal indices of 0, or resolving to -1, rejected
+const uint32_t CACHE_VERSION = 4;
+const char* CACHE_EXTENSION = ".meshcache";
+const size_t ARRAY_ALIGNMENT = 64;
+const size_t HASH_BLOCK_SIZE = 64 << 20;
+
+enum ArrayId {
+    Vertices,
+    Uvs,
+    Normals,
+    VertexIndices,
+    UvIndices,
+    NormalIndices,
+    NumArrays
+};
+
+struct CacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t variant;
+    uint64_t path_hash;
+    uint64_t source_size;
+    int64_t source_mtime;
+    uint64_t content_hash;
+    uint64_t counts[NumArrays];
+    uint64_t offsets[NumArrays];
+};
+
+const size_t ELEMENT_SIZES[NumArrays] = {
+    sizeof(glm::vec3), sizeof(glm::vec2), sizeof(glm::vec3),
+    sizeof(unsigned int), sizeof(unsigned int), sizeof(unsigned int)
+};
+
+bool sourceInfo(const std::string& path, uint64_t& size, int64_t& mtime)
+{
+    std::error_code ec;
+    size = fs::file_size(path, ec);
+    if (ec) return false;
+    auto time = fs::last_write_time(path, ec);
+    if (ec) return false;
+    mtime = static_cast<int64_t>(time.time_since_epoch().count());
+    return true;
+}
+
+// Hashes fixed-size blocks in parallel and then hashes the block hashes.
+uint64_t hashContent(const char* data, size_t size)
+{
+    size_t num_blocks = (size + HASH_BLOCK_SIZE - 1) / HASH_BLOCK_SIZE;
+    std::vector<uint64_t> block_hashes(num_blocks);
+    Parallel::forRange(num_blocks, 1, [&](size_t begin, size_t end) {
+        for (size_t b = begin; b < end; ++b) {
+            size_t offset = b * HASH_BLOCK_SIZE;
+            size_t length = std::min(HASH_BLOCK_SIZE, size - offset);
+            block_hashes[b] = Hash::xxh64(data + offset, length);
+        }
+    });
+    return Hash::xxh64(block_hashes.data(), block_hashes.size() * sizeof(uint64_t), size);
+}
+
+bool hashFile(const std::string& path, uint64_t& hash)
+{
+    MappedFile file;
+    if (!file.open(path)) {
+        return false;
+    }
+    hash = hashContent(file.data(), file.size());
+    return true;
+}
+
+uint64_t pathHash(const std::string& path)
+{
+    std::error_code ec;
+    std::string absolute = fs::absolute(path, ec).string();
+    if (ec) absolute = path;
+    return Hash::xxh64(absolute.data(), absolute.size());
+}
+
+size_t alignUp(size_t value)
+{
+    return (value + ARRAY_ALIGNMENT - 1) / ARRAY_ALIGNMENT * ARRAY_ALIGNMENT;
+}
+
+template <typename T>
+void copyArray(const MappedFile& file, const CacheHeader& header, ArrayId id, std::vector<T>& out)
+{
+    out.resize(header.counts[id]);
+    if (!out.empty()) {
+        std::memcpy(out.data(), file.data() + header.offsets[id], out.size() * sizeof(T));
+    }
+}
+
+} // namespace
+
+MeshCache& MeshCache::getInstance()
+{
+    static MeshCache instance;
+    return instance;
+}
+
+void MeshCache::init(const std::string& dir, uint64_t max_size)
+{
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+    directory = ec ? std::string() : dir;
+    max_bytes = max_size;
+}
+
+std::string MeshCache::entryPath(const std::string& source_path, uint32_t variant) const
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx_%u", static_cast<unsigned long long>(pathHash(source_path)), variant);
+    return (fs::path(directory) / (std::string(name) + CACHE_EXTENSION)).string();
+}
+
+bool MeshCache::describe(const std::string& source_path, Source& source)
+{
+    source.hashed = false;
+    return sourceInfo(source_path, source.size, source.mtime);
+}
+
+void MeshCache::hash(const char* data, size_t size, Source& source)
+{
+    source.content_hash = hashContent(data, size);
+    source.hashed = true;
+}
+
+bool MeshCache::hash(const std::string& source_path, Source& source)
+{
+    source.hashed = hashFile(source_path, source.content_hash);
+    return source.hashed;
+}
+
+bool MeshCache::load(const std::string& source_path, uint32_t variant, Mesh& mesh)
+{
+    if (!enabled()) {
+        return false;
+    }
+
+    uint64_t source_size;
+    int64_t source_mtime;
+    if (!sourceInfo(source_path, source_size, source_mtime)) {
+        return false;
+    }
+
+    const std::string entry = entryPath(source_path, variant);
+    MappedFile file;
+    if (!file.open(entry) || file.size() < sizeof(CacheHeader)) {
+        return false;
+    }
+
+    CacheHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 ||
+        header.version != CACHE_VERSION || header.variant != variant ||
+        header.path_hash != pathHash(source_path) ||
+        header.source_size != source_size) {
+        return false;
+    }
+    for (int id = 0; id < NumArrays; ++id) {
+        if (header.offsets[id] > file.size() || header.counts[id] > (file.size() - header.offsets[id]) / ELEMENT_SIZES[id]) {
+            return false;
+        }
+    }
+
+    if (header.source_mtime != source_mtime) {
+        // Touched but possibly unchanged; trust the entry only if the content matches
+        uint64_t content_hash;
+        if (!hashFile(source_path, content_hash) || content_hash != header.content_hash) {
+            return false;
+        }
+        std::fstream update(entry, std::ios::binary | std::ios::in | std::ios::out);
+        update.seekp(offsetof(CacheHeader, source_mtime));
+        update.write(reinterpret_cast<const char*>(&source_mtime), sizeof(source_mtime));
+    }
+
+    copyArray(file, header, Vertices, mesh.vertices);
+    copyArray(file, header, Uvs, mesh.uvs);
+    copyArray(file, header, Normals, mesh.normals);
+    copyArray(file, header, VertexIndices, mesh.vertex_indices);
+    copyArray(file, header, UvIndices, mesh.uv_indices);
+    copyArray(file, header, NormalIndices, mesh.normal_indices);
+
+    // Mark as recently used for eviction
+    std::error_code ec;
+    fs::last_write_time(entry, fs::file_time_type::clock::now(), ec);
+    return true;
+}
+
+void MeshCache::store(const std::string& source_path, uint32_t variant, const Source& source, const Mesh& mesh)
+{
+    if (!enabled() || !source.hashed) {
+        return;
+    }
+
+    CacheHeader header = {};
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = CACHE_VERSION;
+    header.variant = variant;
+    header.path_hash = pathHash(source_path);
+    header.source_size = source.size;
+    header.source_mtime = source.mtime;
+    header.content_hash = source.content_hash;
+
+    const void* arrays[NumArrays] = {
+        mesh.vertices.data(), mesh.uvs.data(), mesh.normals.data(),
+        mesh.vertex_indices.data(), mesh.uv_indices.data(), mesh.normal_indices.data()
+    };
+    header.counts[Vertices] = mesh.vertices.size();
+    header.counts[Uvs] = mesh.uvs.size();
+    header.counts[Normals] = mesh.normals.size();
+    header.counts[VertexIndices] = mesh.vertex_indices.size();
+    header.counts[UvIndices] = mesh.uv_indices.size();
+    header.counts[NormalIndices] = mesh.normal_indices.size();
+
+    size_t offset = alignUp(sizeof(CacheHeader));
+    for (int id = 0; id < NumArrays; ++id) {
+        header.offsets[id] = offset;
+        offset = alignUp(offset + header.counts[id] * ELEMENT_SIZES[id]);
+    }
+
+    // Write to a private temporary file and rename it into place so that
+    // concurrent readers never see a partial entry.
+    const std::string entry = entryPath(source_path, variant);
+    std::ostringstream temp_name;
+    temp_name << entry << ".tmp" << std::hash<std::thread::id>()(std::this_thread::get_id());
+    const std::string temp = temp_name.str();
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            return;
+        }
+        const char padding[ARRAY_ALIGNMENT] = {};
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        size_t written = sizeof(header);
+        for (int id = 0; id < NumArrays; ++id) {
+            out.write(padding, header.offsets[id] - written);
+            size_t bytes = header.counts[id] * ELEMENT_SIZES[id];
+            out.write(static_cast<const char*>(arrays[id]), bytes);
+            written = header.offsets[id] + bytes;
+        }
+        if (!out) {
+            out.close();
+            std::error_code ec;
+            fs::remove(temp, ec);
+            return;
+        }
+    }
+
+    std::error_code ec;
+    fs::rename(temp, entry, ec);
+    if (ec) {
+        fs::remove(temp, ec);
+        return;
+    }
+
+    evict();
+}
+
+void MeshCache::evict()
+{
+    if (max_bytes == 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(evict_mutex);
+
+    struct Entry {
+        fs::path path;
+        uint64_t size;
+        fs::file_time_type last_used;
+    };
+    std::vector<Entry> entries;
+    uint64_t total = 0;
+
+    std::error_code ec;
+    for (const auto& item : fs::directory_iterator(directory, ec)) {
+        if (!item.is_regular_file(ec) || item.path().extension() != CACHE_EXTENSION) {
+            continue;
+        }
+        Entry entry = {item.path(), item.file_size(ec), item.last_write_time(ec)};
+        total += entry.size;
+        entries.push_back(entry);
+    }
+    if (total <= max_bytes) {
+        return;
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return a.last_used < b.last_used;
+    });
+    for (const auto& entry : entries) {
+        if (total <= max_bytes) {
+            break;
+        }
+        if (fs::remove(entry.path, ec)) {
+            total -= entry.size;
+        }
+    }
+}
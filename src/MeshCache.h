@@ -0,0 +1,62 @@
+#ifndef MESHCACHE_H
+#define MESHCACHE_H
+
+#include "Mesh.h"
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+// On-disk cache of parsed meshes. Each source file gets a sidecar in the cache
+// directory holding the Mesh arrays in a flat, 64-byte aligned layout that is
+// memory-mapped and copied straight into the Mesh on a hit.
+//
+// Entries are keyed by source path, loader variant, size and modification
+// time, and carry a version that is bumped whenever the loaders change what
+// they produce. When only the modification time differs, the content hash
+// decides whether the entry is still valid. The least recently used entries are evicted once the
+// directory grows past its size limit.
+class MeshCache
+{
+public:
+    static MeshCache& getInstance();
+
+    void init(const std::string& directory, uint64_t max_bytes);
+    bool enabled() const { return !directory.empty(); }
+
+    // What an entry records about its source file. Taken before the file is
+    // parsed, so that an entry never claims a newer source than the mesh it
+    // holds.
+    struct Source {
+        uint64_t size = 0;
+        int64_t mtime = 0;
+        uint64_t content_hash = 0;
+        bool hashed = false;
+    };
+
+    // Size and modification time of source_path
+    static bool describe(const std::string& source_path, Source& source);
+    // Content hash of the bytes the parser reads, when it maps the whole
+    // file, or else of the file read once more
+    static void hash(const char* data, size_t size, Source& source);
+    static bool hash(const std::string& source_path, Source& source);
+
+    // 'variant' distinguishes the loader layouts, options and backends that
+    // give different meshes for the same source file.
+    bool load(const std::string& source_path, uint32_t variant, Mesh& mesh);
+    // Skipped unless source was described and hashed
+    void store(const std::string& source_path, uint32_t variant, const Source& source, const Mesh& mesh);
+
+private:
+    MeshCache() {}
+    MeshCache(const MeshCache&) = delete;
+    void operator=(const MeshCache&) = delete;
+
+    std::string entryPath(const std::string& source_path, uint32_t variant) const;
+    void evict();
+
+    std::string directory;
+    uint64_t max_bytes = 0;
+    std::mutex evict_mutex;
+};
+
+#endif // MESHCACHE_H
@@ -1,8 +1,18 @@
 #include "MeshChecker.h"
 #include "UvChecker.h"
+#include "CheckLimit.h"
 #include "Logger.h"
+#include "WorkerArena.h"
+#include "CompactMesh.h"
+#include "TaskScheduler.h"
+#include "Parallel.h"
+#include "TriangleFilter.h"
+#include "TopologyEngine.h"
+#include "DegenerateChecker.h"
+#include "Hash.h"
 
 #include <CGAL/Simple_cartesian.h>
+#include <CGAL/Exact_predicates_inexact_constructions_kernel.h>
 #include <CGAL/Surface_mesh.h>
 #include <CGAL/Polygon_mesh_processing/orient_polygon_soup.h>
 #include <CGAL/Polygon_mesh_processing/repair_polygon_soup.h>
@@ -16,12 +26,19 @@
 #include <CGAL/Polygon_mesh_processing/measure.h>
 #include <CGAL/boost/graph/helpers.h>
 #include <CGAL/Side_of_triangle_mesh.h>
-#include <CGAL/AABB_tree.h>
-#include <CGAL/AABB_traits.h>
-#include <CGAL/AABB_triangle_primitive.h>
+#include <CGAL/intersections.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
 #include <set>
+#include <unordered_map>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
 #include <numeric>
-#include <thread>
 #include <vector>
 
 namespace PMP = CGAL::Polygon_mesh_processing;
@@ -32,15 +49,764 @@ typedef K::Triangle_3 Triangle;
 typedef CGAL::Surface_mesh<Point> CGALMesh;
 typedef CGALMesh::Face_index face_descriptor;
 typedef CGALMesh::Halfedge_index halfedge_descriptor;
+typedef CGALMesh::Vertex_index vertex_descriptor;
 
-typedef std::vector<Triangle>::iterator Triangle_iterator;
-typedef CGAL::AABB_triangle_primitive<K, Triangle_iterator> Primitive;
-typedef CGAL::AABB_traits<K, Primitive> Traits;
-typedef CGAL::AABB_tree<Traits> Tree;
+// Exact predicates for the triangle pairs TriangleFilter cannot reject
+typedef CGAL::Exact_predicates_inexact_constructions_kernel EK;
+typedef EK::Point_3 ExactPoint;
+typedef EK::Triangle_3 ExactTriangle;
+typedef EK::Segment_3 ExactSegment;
 
-MeshChecker::CheckResult MeshChecker::check(const Mesh& mesh, const std::set<CheckType>& checksToPerform)
+namespace {
+
+// Polygon soup handed to CGAL. Kept in the worker arena between calls; the
+// inner polygon vectors are overwritten in place so their storage survives.
+struct SoupBuffers {
+    std::vector<Point> points;
+    std::vector<std::vector<std::size_t>> polygons;
+    std::vector<std::size_t> polygon_faces;
+};
+
+SoupBuffers& soupBuffers(WorkerArena* arena, std::unique_ptr<SoupBuffers>& local)
+{
+    if (!arena) {
+        local.reset(new SoupBuffers);
+        return *local;
+    }
+    if (!arena->checker_buffers) {
+        arena->checker_buffers = std::make_shared<SoupBuffers>();
+    }
+    return *static_cast<SoupBuffers*>(arena->checker_buffers.get());
+}
+
+// Uniform access to Mesh and CompactMesh for the code below. Compact meshes
+// are dequantized here, one position at a time.
+size_t vertexCount(const Mesh& mesh) { return mesh.vertices.size(); }
+size_t vertexCount(const CompactMesh& mesh) { return mesh.vertexCount(); }
+size_t indexCount(const Mesh& mesh) { return mesh.vertex_indices.size(); }
+size_t indexCount(const CompactMesh& mesh) { return mesh.indexCount(); }
+unsigned int cornerIndex(const Mesh& mesh, size_t corner) { return mesh.vertex_indices[corner]; }
+unsigned int cornerIndex(const CompactMesh& mesh, size_t corner) { return mesh.index(corner); }
+Point vertexPoint(const Mesh& mesh, size_t vertex)
+{
+    const glm::vec3& p = mesh.vertices[vertex];
+    return Point(p.x, p.y, p.z);
+}
+Point vertexPoint(const CompactMesh& mesh, size_t vertex)
+{
+    const glm::vec3 p = mesh.position(vertex);
+    return Point(p.x, p.y, p.z);
+}
+
+template <typename MeshType>
+void buildTriangles(const MeshType& mesh, std::vector<Triangle>& triangles)
+{
+    triangles.reserve(indexCount(mesh) / 3);
+    for (size_t i = 0; i + 2 < indexCount(mesh); i += 3) {
+        triangles.emplace_back(vertexPoint(mesh, cornerIndex(mesh, i)),
+                               vertexPoint(mesh, cornerIndex(mesh, i + 1)),
+                               vertexPoint(mesh, cornerIndex(mesh, i + 2)));
+    }
+}
+
+// Triangle pair search shared by the self-intersection and mannequin checks:
+// a bounding volume hierarchy whose traversal is split into scheduler tasks,
+// then TriangleFilter, then exact predicates for the pairs the filter keeps.
+namespace TrianglePairs {
+
+// Faces per BVH leaf and per traversal task
+const size_t LEAF_SIZE = 4;
+const size_t QUERY_BLOCK = 4096;
+
+struct Box {
+    double min[3];
+    double max[3];
+
+    void extend(const Box& other) {
+        for (int axis = 0; axis < 3; ++axis) {
+            min[axis] = std::min(min[axis], other.min[axis]);
+            max[axis] = std::max(max[axis], other.max[axis]);
+        }
+    }
+    // Closed boxes, like CGAL's box_self_intersection_d
+    bool overlaps(const Box& other) const {
+        for (int axis = 0; axis < 3; ++axis) {
+            if (min[axis] > other.max[axis] || other.min[axis] > max[axis]) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+template <typename TriangleType>
+Box triangleBox(const TriangleType& triangle)
+{
+    Box box;
+    for (int axis = 0; axis < 3; ++axis) {
+        box.min[axis] = std::min({triangle[0][axis], triangle[1][axis], triangle[2][axis]});
+        box.max[axis] = std::max({triangle[0][axis], triangle[1][axis], triangle[2][axis]});
+    }
+    return box;
+}
+
+ExactPoint exactPoint(const Point& p)
+{
+    return ExactPoint(p.x(), p.y(), p.z());
+}
+
+// Float copy of a triangle for TriangleFilter
+template <typename TriangleType>
+TriangleFilter::Triangle filterTriangle(const TriangleType& triangle)
+{
+    double coords[3][3];
+    for (int k = 0; k < 3; ++k) {
+        for (int axis = 0; axis < 3; ++axis) {
+            coords[k][axis] = triangle[k][axis];
+        }
+    }
+    return TriangleFilter::fromDoubles(coords[0], coords[1], coords[2]);
+}
+
+// Candidate pairs collected per task before they go through the filter
+const size_t FILTER_BATCH = 256;
+
+// Runs the pairs through TriangleFilter and calls exact(pair) for the ones it
+// cannot reject, then empties 'pairs'.
+template <typename Exact>
+void filterPairs(const std::vector<TriangleFilter::Triangle>& first, const std::vector<TriangleFilter::Triangle>& second,
+                 std::vector<std::pair<unsigned int, unsigned int>>& pairs, const Exact& exact)
+{
+    unsigned char may_intersect[FILTER_BATCH];
+    for (size_t begin = 0; begin < pairs.size(); begin += FILTER_BATCH) {
+        const size_t count = std::min(FILTER_BATCH, pairs.size() - begin);
+        TriangleFilter::classify(first.data(), second.data(), pairs.data() + begin, count, may_intersect);
+        for (size_t i = 0; i < count; ++i) {
+            if (may_intersect[i]) {
+                exact(pairs[begin + i]);
+            }
+        }
+    }
+    pairs.clear();
+}
+
+// 30-bit Morton code of a point inside 'bounds'
+uint32_t mortonCode(const Point& p, const Box& bounds)
+{
+    uint32_t code = 0;
+    uint32_t cell[3];
+    for (int axis = 0; axis < 3; ++axis) {
+        const double extent = bounds.max[axis] - bounds.min[axis];
+        const double t = extent > 0 ? (p[axis] - bounds.min[axis]) / extent : 0.0;
+        cell[axis] = static_cast<uint32_t>(std::min(1023.0, std::max(0.0, t * 1024.0)));
+    }
+    for (int bit = 9; bit >= 0; --bit) {
+        for (int axis = 0; axis < 3; ++axis) {
+            code = (code << 1) | ((cell[axis] >> bit) & 1);
+        }
+    }
+    return code;
+}
+
+// Implicit binary tree over faces sorted along a Morton curve. Node i has
+// children 2i+1 and 2i+2, and the nodes of each level split the sorted faces
+// into equal ranges.
+struct Hierarchy {
+    std::vector<unsigned int> faces;
+    std::vector<Box> face_boxes; // In sorted order
+    std::vector<Box> node_boxes;
+    size_t depth = 0;
+
+    size_t rangeBegin(size_t level, size_t k) const { return faces.size() * k >> level; }
+
+    void build(const std::vector<Box>& boxes, std::vector<unsigned int> face_list)
+    {
+        faces = std::move(face_list);
+        const size_t count = faces.size();
+        depth = 0;
+        while ((count >> depth) > LEAF_SIZE) {
+            ++depth;
+        }
+
+        Box bounds = boxes[faces[0]];
+        for (unsigned int f : faces) {
+            bounds.extend(boxes[f]);
+        }
+        std::vector<std::pair<uint32_t, unsigned int>> keyed(count);
+        Parallel::forRange(count, 1 << 14, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                const Box& box = boxes[faces[i]];
+                const Point center((box.min[0] + box.max[0]) / 2, (box.min[1] + box.max[1]) / 2, (box.min[2] + box.max[2]) / 2);
+                keyed[i] = std::make_pair(mortonCode(center, bounds), faces[i]);
+            }
+        });
+        Parallel::sort(keyed.begin(), keyed.end(), std::less<std::pair<uint32_t, unsigned int>>());
+
+        face_boxes.resize(count);
+        Parallel::forRange(count, 1 << 14, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                faces[i] = keyed[i].second;
+                face_boxes[i] = boxes[faces[i]];
+            }
+        });
+
+        // Leaves first, then each level from its children
+        node_boxes.resize((size_t(2) << depth) - 1);
+        const size_t first_leaf = (size_t(1) << depth) - 1;
+        Parallel::forRange(size_t(1) << depth, 1 << 10, [&](size_t begin, size_t end) {
+            for (size_t k = begin; k < end; ++k) {
+                Box& box = node_boxes[first_leaf + k];
+                box = face_boxes[rangeBegin(depth, k)];
+                for (size_t i = rangeBegin(depth, k) + 1; i < rangeBegin(depth, k + 1); ++i) {
+                    box.extend(face_boxes[i]);
+                }
+            }
+        });
+        for (size_t level = depth; level-- > 0;) {
+            const size_t first = (size_t(1) << level) - 1;
+            Parallel::forRange(size_t(1) << level, 1 << 12, [&](size_t begin, size_t end) {
+                for (size_t k = begin; k < end; ++k) {
+                    const size_t node = first + k;
+                    node_boxes[node] = node_boxes[2 * node + 1];
+                    node_boxes[node].extend(node_boxes[2 * node + 2]);
+                }
+            });
+        }
+    }
+
+    // Calls visit(j) for every sorted position j >= first whose box overlaps
+    // 'box'. Querying face_boxes[i] from i + 1 sees each pair once.
+    template <typename Visit>
+    void query(const Box& box, size_t first, const Visit& visit) const
+    {
+        struct Entry { size_t node, level, k; };
+        Entry stack[64];
+        size_t top = 0;
+        stack[top++] = {0, 0, 0};
+        while (top > 0) {
+            const Entry entry = stack[--top];
+            if (rangeBegin(entry.level, entry.k + 1) <= first || !node_boxes[entry.node].overlaps(box)) {
+                continue;
+            }
+            if (entry.level == depth) {
+                const size_t begin = std::max(rangeBegin(entry.level, entry.k), first);
+                for (size_t j = begin; j < rangeBegin(entry.level, entry.k + 1); ++j) {
+                    if (face_boxes[j].overlaps(box)) {
+                        visit(j);
+                    }
+                }
+                continue;
+            }
+            stack[top++] = {2 * entry.node + 2, entry.level + 1, 2 * entry.k + 1};
+            stack[top++] = {2 * entry.node + 1, entry.level + 1, 2 * entry.k};
+        }
+    }
+};
+
+// The test PMP::self_intersections applies to a pair of faces whose boxes
+// overlap, with exact predicates. Faces sharing an edge intersect only if
+// they fold onto each other; faces sharing a vertex only if the edge opposite
+// that vertex in one face meets the other face.
+bool facesIntersect(const CGALMesh& mesh, face_descriptor f, face_descriptor g, const ExactTriangle& tf, const ExactTriangle& tg)
 {
-    CheckResult result;
+    halfedge_descriptor h = mesh.halfedge(f);
+    const halfedge_descriptor hg = mesh.halfedge(g);
+    for (int i = 0; i < 3; ++i) {
+        halfedge_descriptor k = hg;
+        for (int j = 0; j < 3; ++j) {
+            if (mesh.opposite(h) == k) {
+                const ExactPoint p = exactPoint(mesh.point(mesh.source(h)));
+                const ExactPoint q = exactPoint(mesh.point(mesh.target(h)));
+                const ExactPoint r = exactPoint(mesh.point(mesh.target(mesh.next(h))));
+                const ExactPoint s = exactPoint(mesh.point(mesh.target(mesh.next(k))));
+                return CGAL::coplanar(p, q, r, s) && CGAL::coplanar_orientation(p, q, r, s) == CGAL::POSITIVE;
+            }
+            k = mesh.next(k);
+        }
+        h = mesh.next(h);
+    }
+
+    for (int i = 0; i < 3; ++i) {
+        halfedge_descriptor k = hg;
+        for (int j = 0; j < 3; ++j) {
+            if (mesh.target(h) == mesh.target(k)) {
+                const ExactSegment opposite_f(exactPoint(mesh.point(mesh.target(mesh.next(h)))), exactPoint(mesh.point(mesh.source(h))));
+                const ExactSegment opposite_g(exactPoint(mesh.point(mesh.target(mesh.next(k)))), exactPoint(mesh.point(mesh.source(k))));
+                return CGAL::do_intersect(tf, opposite_g) || CGAL::do_intersect(tg, opposite_f);
+            }
+            k = mesh.next(k);
+        }
+        h = mesh.next(h);
+    }
+
+    return CGAL::do_intersect(tf, tg);
+}
+
+// Parallel replacement for PMP::self_intersections on a freshly built
+// Surface_mesh. Degenerate faces are reported paired with themselves and
+// left out of the pair search, as PMP::self_intersections does. Returns
+// false if the search stopped at the limit; the pairs written are then the
+// lowest of those found, at most limit.limit of them. Progress is reported
+// to the limit per block of queried faces.
+template <typename OutputIterator>
+bool selfIntersections(const CGALMesh& mesh, OutputIterator out, const CheckLimit& limit = CheckLimit())
+{
+    const size_t num_faces = mesh.number_of_faces();
+    std::vector<ExactTriangle> triangles(num_faces);
+    std::vector<TriangleFilter::Triangle> filter_triangles(num_faces);
+    std::vector<Box> boxes(num_faces);
+    std::vector<unsigned char> degenerate(num_faces);
+    Parallel::forRange(num_faces, 1 << 14, [&](size_t begin, size_t end) {
+        for (size_t f = begin; f < end; ++f) {
+            const halfedge_descriptor h = mesh.halfedge(face_descriptor(static_cast<CGALMesh::size_type>(f)));
+            triangles[f] = ExactTriangle(exactPoint(mesh.point(mesh.source(h))),
+                                         exactPoint(mesh.point(mesh.target(h))),
+                                         exactPoint(mesh.point(mesh.target(mesh.next(h)))));
+            filter_triangles[f] = filterTriangle(triangles[f]);
+            boxes[f] = triangleBox(triangles[f]);
+            degenerate[f] = triangles[f].is_degenerate();
+        }
+    });
+
+    std::vector<unsigned int> candidates;
+    candidates.reserve(num_faces);
+    size_t degenerate_count = 0;
+    for (size_t f = 0; f < num_faces; ++f) {
+        if (degenerate[f]) {
+            if (limit.reached(degenerate_count)) {
+                return false;
+            }
+            const face_descriptor fd(static_cast<CGALMesh::size_type>(f));
+            *out++ = std::make_pair(fd, fd);
+            ++degenerate_count;
+        } else {
+            candidates.push_back(static_cast<unsigned int>(f));
+        }
+    }
+    if (candidates.size() < 2) {
+        return true;
+    }
+
+    Hierarchy hierarchy;
+    hierarchy.build(boxes, std::move(candidates));
+
+    // Blocks are small next to the face count so busy threads steal the rest
+    std::vector<std::pair<unsigned int, unsigned int>> pairs;
+    std::mutex pairs_mutex;
+    // Pairs found by all blocks so far, for stopping at the limit
+    std::atomic<size_t> found(degenerate_count);
+    std::atomic<bool> stopped(false);
+    TaskGroup tasks;
+    const size_t count = hierarchy.faces.size();
+    const size_t num_blocks = (count + QUERY_BLOCK - 1) / QUERY_BLOCK;
+    std::atomic<size_t> blocks_done(0);
+    for (size_t block = 0; block < count; block += QUERY_BLOCK) {
+        tasks.run([&, block]() {
+            std::vector<std::pair<unsigned int, unsigned int>> local;
+            std::vector<std::pair<unsigned int, unsigned int>> candidates;
+            candidates.reserve(FILTER_BATCH);
+            auto exact = [&](const std::pair<unsigned int, unsigned int>& pair) {
+                const unsigned int f = pair.first, g = pair.second;
+                if (facesIntersect(mesh, face_descriptor(static_cast<CGALMesh::size_type>(f)), face_descriptor(static_cast<CGALMesh::size_type>(g)), triangles[f], triangles[g])) {
+                    local.emplace_back(std::min(f, g), std::max(f, g));
+                    found.fetch_add(1, std::memory_order_relaxed);
+                }
+            };
+            for (size_t i = block; i < std::min(count, block + QUERY_BLOCK); ++i) {
+                if (limit.shouldStop(found.load(std::memory_order_relaxed))) {
+                    stopped = true;
+                    break;
+                }
+                const unsigned int f = hierarchy.faces[i];
+                hierarchy.query(hierarchy.face_boxes[i], i + 1, [&](size_t j) {
+                    candidates.emplace_back(f, hierarchy.faces[j]);
+                    if (candidates.size() == FILTER_BATCH) {
+                        filterPairs(filter_triangles, filter_triangles, candidates, exact);
+                    }
+                });
+            }
+            filterPairs(filter_triangles, filter_triangles, candidates, exact);
+            limit.report(static_cast<float>(blocks_done.fetch_add(1) + 1) / num_blocks);
+            std::lock_guard<std::mutex> lock(pairs_mutex);
+            pairs.insert(pairs.end(), local.begin(), local.end());
+        });
+    }
+    tasks.wait();
+
+    std::sort(pairs.begin(), pairs.end());
+    if (limit.limit != 0 && degenerate_count + pairs.size() > limit.limit) {
+        pairs.resize(limit.limit - degenerate_count);
+        stopped = true;
+    }
+    for (const auto& pair : pairs) {
+        *out++ = std::make_pair(face_descriptor(static_cast<CGALMesh::size_type>(pair.first)),
+                                face_descriptor(static_cast<CGALMesh::size_type>(pair.second)));
+    }
+    return !stopped;
+}
+
+} // namespace TrianglePairs
+
+// Intermediate structures the checks are run on. Each is built at most once
+// per check() call, and only when a requested check needs it.
+enum class Representation {
+    PolygonSoup,  // CGAL points and polygons, repaired and oriented
+    HalfedgeMesh, // CGAL Surface_mesh built from the soup; self-intersection
+                  // builds its own bounding box tree over it
+    EdgeTable,    // TopologyEngine's sorted edges of the indexed input
+    UvMesh,       // Input Mesh with UVs; UvChecker rasterizes its faces
+    Count
+};
+
+struct CheckPlan {
+    bool required[static_cast<int>(Representation::Count)] = {};
+
+    bool needs(Representation representation) const { return required[static_cast<int>(representation)]; }
+};
+
+// What each check reads. Degenerate faces are measured on the indexed input
+// and need nothing built.
+const std::vector<Representation>& checkRequirements(MeshChecker::CheckType check, MeshCheckOptions::Topology topology)
+{
+    using CheckType = MeshChecker::CheckType;
+    using Topology = MeshCheckOptions::Topology;
+    static const std::vector<Representation> none;
+    static const std::vector<Representation> halfedge = {Representation::HalfedgeMesh};
+    static const std::vector<Representation> edge_table = {Representation::EdgeTable};
+    static const std::vector<Representation> both = {Representation::HalfedgeMesh, Representation::EdgeTable};
+    static const std::vector<Representation> uv = {Representation::UvMesh};
+    switch (check) {
+    case CheckType::Watertight:
+    case CheckType::NonManifold:
+    case CheckType::Holes:
+        return topology == Topology::HalfedgeMesh ? halfedge : topology == Topology::EdgeTable ? edge_table : both;
+    case CheckType::SelfIntersect:
+        return halfedge;
+    case CheckType::UVOverlap:
+    case CheckType::UVBounds:
+        return uv;
+    case CheckType::DegenerateFaces:
+        break;
+    }
+    return none;
+}
+
+CheckPlan planChecks(const std::set<MeshChecker::CheckType>& checksToPerform, MeshCheckOptions::Topology topology)
+{
+    CheckPlan plan;
+    for (MeshChecker::CheckType check : checksToPerform) {
+        for (Representation representation : checkRequirements(check, topology)) {
+            plan.required[static_cast<int>(representation)] = true;
+        }
+    }
+    // The halfedge mesh is built from the soup
+    if (plan.needs(Representation::HalfedgeMesh)) {
+        plan.required[static_cast<int>(Representation::PolygonSoup)] = true;
+    }
+    return plan;
+}
+
+// Thrown by LimitedOutput to end a CGAL enumeration early
+struct StopEnumeration {};
+
+// Output iterator for the CGAL functions that report violations one by one:
+// forwards to 'out' and throws StopEnumeration once the limit says to stop.
+template <typename OutputIterator>
+struct LimitedOutput {
+    using iterator_category = std::output_iterator_tag;
+    using value_type = void;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = void;
+
+    OutputIterator out;
+    size_t* count;
+    const CheckLimit* limit;
+
+    LimitedOutput& operator*() { return *this; }
+    LimitedOutput& operator++() { return *this; }
+    LimitedOutput operator++(int) { return *this; }
+
+    template <typename T>
+    LimitedOutput& operator=(const T& value)
+    {
+        *out++ = value;
+        if (limit->shouldStop(++*count)) {
+            throw StopEnumeration();
+        }
+        return *this;
+    }
+};
+
+// Runs enumerate(output) with an output iterator limited as above. Returns
+// false if it was stopped early.
+template <typename OutputIterator, typename Enumerate>
+bool enumerateLimited(OutputIterator out, const CheckLimit& limit, Enumerate enumerate)
+{
+    size_t count = 0;
+    try {
+        enumerate(LimitedOutput<OutputIterator>{out, &count, &limit});
+    } catch (const StopEnumeration&) {
+        return false;
+    }
+    return true;
+}
+
+// Thrown between the soup conversion stages once the caller has cancelled
+struct CheckCancelled {};
+
+void throwIfCancelled(const CheckLimit& limit)
+{
+    if (limit.cancelled()) {
+        throw CheckCancelled();
+    }
+}
+
+// Overall progress of one check() call for MeshCheckOptions::progress. Each
+// phase counts the same; all phases are added before any starts, so the
+// total never goes back.
+class ProgressTracker
+{
+public:
+    explicit ProgressTracker(const MeshCheckOptions& options) : callback(options.progress) {}
+
+    size_t addPhase(const char* name)
+    {
+        names.push_back(name);
+        fractions.push_back(0.0f);
+        return names.size() - 1;
+    }
+
+    void update(size_t phase, float fraction)
+    {
+        if (!callback) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        fractions[phase] = std::max(fractions[phase], std::min(fraction, 1.0f));
+        float total = 0.0f;
+        for (float f : fractions) {
+            total += f;
+        }
+        total /= fractions.size();
+        const int permille = static_cast<int>(total * 1000.0f);
+        if (permille != reported) {
+            reported = permille;
+            callback(names[phase], total);
+        }
+    }
+
+    // A copy of limit that reports to the given phase
+    CheckLimit phaseLimit(const CheckLimit& limit, size_t phase)
+    {
+        CheckLimit phase_limit = limit;
+        if (callback) {
+            phase_limit.progress = [this, phase](float fraction) { update(phase, fraction); };
+        }
+        return phase_limit;
+    }
+
+private:
+    std::function<void(const std::string&, float)> callback;
+    std::vector<std::string> names;
+    std::vector<float> fractions;
+    int reported = -1;
+    std::mutex mutex;
+};
+
+// Completes a phase when the task running it returns, also on early returns
+struct PhaseDone {
+    ProgressTracker& tracker;
+    size_t phase;
+
+    ~PhaseDone() { tracker.update(phase, 1.0f); }
+};
+
+// Early termination shared by the checks of one check() call
+struct GateState {
+    std::atomic<bool> failed{false};
+    std::atomic<bool> stopped{false};
+    bool stop_on_failure = false;
+    std::chrono::milliseconds time_budget;
+    CheckLimit limit;
+    std::set<MeshChecker::CheckType> completed;
+    std::set<MeshChecker::CheckType> timed_out;
+    std::mutex checks_mutex;
+    // Per check type, set when its deadline stopped it
+    std::atomic<bool> deadline_hit[static_cast<int>(MeshChecker::CheckType::UVBounds) + 1] = {};
+
+    explicit GateState(const MeshCheckOptions& options)
+        : stop_on_failure(options.stop_on_failure), time_budget(options.check_time_budget)
+    {
+        limit.limit = options.violation_limit;
+        limit.abort = options.stop_on_failure ? &failed : nullptr;
+        limit.cancel = options.cancel;
+    }
+
+    // A check that has not started yet is skipped after a failure or a cancel
+    bool skip()
+    {
+        if (limit.aborted()) {
+            stopped = true;
+            return true;
+        }
+        return false;
+    }
+
+    // complete is false when the check stopped before it had seen everything
+    void record(MeshChecker::CheckType check, bool violated, bool complete)
+    {
+        if (violated && stop_on_failure) {
+            failed = true;
+        }
+        if (!complete || deadline_hit[static_cast<int>(check)].load()) {
+            stopped = true;
+            return;
+        }
+        std::lock_guard<std::mutex> lock(checks_mutex);
+        completed.insert(check);
+    }
+
+    // For counting checks that stop at the limit: a count at the limit may be
+    // short
+    void recordCount(MeshChecker::CheckType check, size_t count)
+    {
+        record(check, count > 0, !limit.shouldStop(count));
+    }
+
+    // The limit of one check starting now: the shared one with the check's
+    // own deadline
+    CheckLimit startCheck(MeshChecker::CheckType check)
+    {
+        CheckLimit check_limit = limit;
+        if (time_budget.count() > 0) {
+            check_limit.deadline = std::chrono::steady_clock::now() + time_budget;
+            check_limit.deadline_hit = &deadline_hit[static_cast<int>(check)];
+        }
+        return check_limit;
+    }
+
+    // A check that stopped at its deadline has timed out. One that finished
+    // its work after the deadline has an exact result and has not.
+    void finishCheck(MeshChecker::CheckType check)
+    {
+        if (deadline_hit[static_cast<int>(check)].load()) {
+            stopped = true;
+            std::lock_guard<std::mutex> lock(checks_mutex);
+            timed_out.insert(check);
+            Logger::getInstance().log(std::string(MeshChecker::checkName(check)) + " check timed out, its result is partial.");
+        }
+    }
+};
+
+// Fills result.hole_metrics from result.hole_loops; position(v) is the
+// Point of vertex v.
+template <typename Position>
+void measureHoles(MeshChecker::CheckResult& result, const Position& position)
+{
+    result.hole_metrics.clear();
+    result.hole_metrics.reserve(result.hole_loops.size());
+    for (const auto& loop : result.hole_loops) {
+        MeshChecker::HoleMetrics metrics;
+        if (!loop.empty()) {
+            const Point origin = position(loop[0]);
+            K::Vector_3 vector_area(0, 0, 0);
+            double perimeter = 0;
+            for (size_t i = 0; i < loop.size(); ++i) {
+                const Point p = position(loop[i]);
+                const Point q = position(loop[(i + 1) % loop.size()]);
+                perimeter += std::sqrt(CGAL::squared_distance(p, q));
+                vector_area = vector_area + CGAL::cross_product(p - origin, q - origin);
+                const glm::vec3 corner(static_cast<float>(p.x()), static_cast<float>(p.y()), static_cast<float>(p.z()));
+                metrics.bounds.min = glm::min(metrics.bounds.min, corner);
+                metrics.bounds.max = glm::max(metrics.bounds.max, corner);
+            }
+            metrics.perimeter = static_cast<float>(perimeter);
+            metrics.area = static_cast<float>(0.5 * std::sqrt(vector_area.squared_length()));
+        }
+        result.hole_metrics.push_back(metrics);
+    }
+}
+
+// Input vertex of a CGAL vertex, to report hole loops in input indices.
+// polygon_soup_to_polygon_mesh creates vertex i from soup point i, and the
+// soup starts out as the input's points, so vertex i is input vertex i
+// whenever their positions agree. Soup repair merges and drops points and
+// orientation appends duplicates, so the remaining vertices are looked up by
+// position: every CGAL point is still exactly the position of some input
+// vertex. That table is only built for the first such vertex, and maps a
+// position shared by several input vertices to the lowest of them.
+template <typename MeshType>
+class InputVertexLookup
+{
+public:
+    explicit InputVertexLookup(const MeshType& mesh) : mesh(mesh) {}
+
+    // False if no input vertex is at the vertex's position
+    bool find(size_t cgal_vertex, const Point& point, unsigned int& input_vertex)
+    {
+        if (cgal_vertex < vertexCount(mesh) && vertexPoint(mesh, cgal_vertex) == point) {
+            input_vertex = static_cast<unsigned int>(cgal_vertex);
+            return true;
+        }
+        if (by_position.empty()) {
+            by_position.reserve(vertexCount(mesh));
+            for (size_t v = 0; v < vertexCount(mesh); ++v) {
+                by_position.emplace(vertexPoint(mesh, v), static_cast<unsigned int>(v));
+            }
+        }
+        auto it = by_position.find(point);
+        if (it == by_position.end()) {
+            return false;
+        }
+        input_vertex = it->second;
+        return true;
+    }
+
+private:
+    struct PointHash {
+        size_t operator()(const Point& point) const
+        {
+            const double coordinates[3] = {point.x(), point.y(), point.z()};
+            return static_cast<size_t>(Hash::xxh64(coordinates, sizeof(coordinates)));
+        }
+    };
+
+    const MeshType& mesh;
+    std::unordered_map<Point, unsigned int, PointHash> by_position;
+};
+
+// Logs each topology result where the halfedge mesh and the edge table
+// disagree. Soup repair can legitimately change the topology, so this is a
+// diagnostic and not an error.
+void crossValidateTopology(const MeshChecker::CheckResult& result, const TopologyEngine::Result& edge_topology,
+                           const std::set<MeshChecker::CheckType>& checksToPerform)
+{
+    using CheckType = MeshChecker::CheckType;
+    auto compare = [](const char* name, const std::string& halfedge, const std::string& edge_table) {
+        if (halfedge != edge_table) {
+            Logger::getInstance().log(std::string("Topology mismatch in ") + name + ": halfedge mesh " + halfedge +
+                                      ", edge table " + edge_table);
+        }
+    };
+    if (checksToPerform.count(CheckType::Watertight)) {
+        compare("watertightness", result.is_watertight ? "Yes" : "No", edge_topology.is_closed ? "Yes" : "No");
+    }
+    if (checksToPerform.count(CheckType::NonManifold)) {
+        compare("non-manifold vertices", std::to_string(result.non_manifold_vertices_count),
+                std::to_string(edge_topology.non_manifold_vertices_count));
+    }
+    if (checksToPerform.count(CheckType::Holes)) {
+        compare("holes", std::to_string(result.holes_count), std::to_string(edge_topology.border_loops.size()));
+    }
+}
+
+// uv_mesh is the mesh the UV checks read, if it has UVs at all.
+template <typename MeshType>
+MeshChecker::CheckResult checkMesh(const MeshType& mesh, const Mesh* uv_mesh, const std::set<MeshChecker::CheckType>& checksToPerform, const MeshCheckOptions& options)
+{
+    using CheckType = MeshChecker::CheckType;
+    MeshChecker::CheckResult result;
     // Initialize results
     result.is_watertight = false;
     result.non_manifold_vertices_count = 0;
@@ -52,201 +818,394 @@ MeshChecker::CheckResult MeshChecker::check(const Mesh& mesh, const std::set<Che
     result.uvs_out_of_bounds_count = 0;
 
     try {
-        Logger::getInstance().log("Starting mesh conversion to CGAL format...");
+        const CheckPlan plan = planChecks(checksToPerform, options.topology);
+        // Topology checks whose reported result comes from the halfedge mesh
+        const bool halfedge_topology = options.topology != MeshCheckOptions::Topology::EdgeTable;
+        GateState gate(options);
+        const CheckLimit& limit = gate.limit;
 
-        std::vector<Point> points;
-        points.reserve(mesh.vertices.size());
-        for (const auto& v : mesh.vertices) {
-            points.emplace_back(v.x, v.y, v.z);
-        }
-
-        std::vector<std::vector<std::size_t>> polygons;
-        polygons.reserve(mesh.vertex_indices.size() / 3);
-        for (size_t i = 0; i < mesh.vertex_indices.size(); i += 3) {
-            polygons.push_back({mesh.vertex_indices[i], mesh.vertex_indices[i+1], mesh.vertex_indices[i+2]});
-        }
-
-        try {
-            Logger::getInstance().log("Repairing polygon soup...");
-            CGAL::Polygon_mesh_processing::repair_polygon_soup(points, polygons);
-            Logger::getInstance().log("Orienting polygon soup...");
-            CGAL::Polygon_mesh_processing::orient_polygon_soup(points, polygons);
-        } catch (const std::exception& e) {
-            Logger::getInstance().log("CGAL Exception during soup processing: " + std::string(e.what()));
-        }
+        ProgressTracker progress(options);
+        auto addPhase = [&](bool used, const char* name) { return used ? progress.addPhase(name) : 0; };
+        const size_t degenerate_phase = addPhase(checksToPerform.count(CheckType::DegenerateFaces) > 0, "Degenerate faces");
+        const size_t edge_table_phase = addPhase(plan.needs(Representation::EdgeTable), "Edge table");
+        const size_t conversion_phase = addPhase(plan.needs(Representation::PolygonSoup), "Mesh conversion");
+        const size_t watertight_phase = addPhase(plan.needs(Representation::HalfedgeMesh) && halfedge_topology && checksToPerform.count(CheckType::Watertight), "Watertightness");
+        const size_t non_manifold_phase = addPhase(plan.needs(Representation::HalfedgeMesh) && halfedge_topology && checksToPerform.count(CheckType::NonManifold), "Non-manifold vertices");
+        const size_t self_intersection_phase = addPhase(checksToPerform.count(CheckType::SelfIntersect) > 0, "Self-intersections");
+        const size_t holes_phase = addPhase(plan.needs(Representation::HalfedgeMesh) && halfedge_topology && checksToPerform.count(CheckType::Holes), "Holes");
+        const size_t uv_phase = addPhase(plan.needs(Representation::UvMesh), "UVs");
 
+        std::pmr::memory_resource* resource = options.arena ? options.arena->resource() : std::pmr::get_default_resource();
+        // Declared before the task group so it outlives the tasks
         CGALMesh cgal_mesh;
-        CGAL::Polygon_mesh_processing::polygon_soup_to_polygon_mesh(points, polygons, cgal_mesh);
-        Logger::getInstance().log("Mesh conversion finished.");
-        
-        // Create a property map to store original face indices
         CGALMesh::Property_map<face_descriptor, std::size_t> original_face_indices;
-        bool created;
-        boost::tie(original_face_indices, created) = cgal_mesh.add_property_map<face_descriptor, std::size_t>("f:original_index", 0);
+        TopologyEngine::Result edge_topology;
 
-        // We need to re-associate faces in the cgal_mesh with original indices.
-        // This is tricky after soup processing. A robust way is to map vertex indices.
-        // For now, we assume the order is maintained by polygon_soup_to_polygon_mesh.
-        std::size_t face_idx_counter = 0;
-        for(face_descriptor fd : faces(cgal_mesh)) {
-            original_face_indices[fd] = face_idx_counter++;
-        }
-
-        std::vector<std::thread> threads;
-
-        if (checksToPerform.count(CheckType::Watertight)) {
-            threads.emplace_back([&]() {
-                Logger::getInstance().log("Checking watertightness...");
-                result.is_watertight = CGAL::is_closed(cgal_mesh);
-                Logger::getInstance().log(std::string("Watertight: ") + (result.is_watertight ? "Yes" : "No"));
-            });
-        }
+        // Each check is a scheduler task; the group also waits for them if
+        // building a representation throws while earlier checks are running
+        TaskGroup tasks;
 
-        if (checksToPerform.count(CheckType::NonManifold)) {
-            threads.emplace_back([&]() {
-                Logger::getInstance().log("Checking non-manifold vertices...");
-                std::vector<halfedge_descriptor> non_manifold_halfedges;
-                CGAL::Polygon_mesh_processing::non_manifold_vertices(cgal_mesh, std::back_inserter(non_manifold_halfedges));
-                result.non_manifold_vertices_count = non_manifold_halfedges.size();
-                std::set<std::size_t> non_manifold_faces_set;
-                for (const auto& h : non_manifold_halfedges) {
-                     if(!is_border(h, cgal_mesh))
-                        non_manifold_faces_set.insert(original_face_indices[face(h, cgal_mesh)]);
+        // Checks on the indexed input need nothing built and start right away
+        if (checksToPerform.count(CheckType::DegenerateFaces)) {
+            tasks.run([&]() {
+                PhaseDone done{progress, degenerate_phase};
+                if (gate.skip()) {
+                    return;
                 }
-                result.non_manifold_faces.assign(non_manifold_faces_set.begin(), non_manifold_faces_set.end());
-                Logger::getInstance().log("Non-manifold vertices found: " + std::to_string(result.non_manifold_vertices_count));
+                Logger::getInstance().log("Checking for degenerate faces...");
+                const CheckLimit check_limit = gate.startCheck(CheckType::DegenerateFaces);
+                result.degenerate_faces_count = DegenerateChecker::findDegenerateFaces(mesh, result.degenerate_faces, options.degenerate_thresholds,
+                                                                                       progress.phaseLimit(check_limit, degenerate_phase));
+                gate.recordCount(CheckType::DegenerateFaces, result.degenerate_faces_count);
+                gate.finishCheck(CheckType::DegenerateFaces);
+                Logger::getInstance().log("Degenerate faces found: " + std::to_string(result.degenerate_faces_count));
             });
         }
 
-        if (checksToPerform.count(CheckType::SelfIntersect)) {
-            threads.emplace_back([&]() {
-                Logger::getInstance().log("Checking self-intersections...");
-                std::vector<std::pair<face_descriptor, face_descriptor>> self_intersections;
-                CGAL::Polygon_mesh_processing::self_intersections(cgal_mesh, std::back_inserter(self_intersections));
-                result.self_intersections_count = self_intersections.size();
-                std::set<std::size_t> intersecting_faces_set;
-                for(const auto& pair : self_intersections) {
-                    intersecting_faces_set.insert(original_face_indices[pair.first]);
-                    intersecting_faces_set.insert(original_face_indices[pair.second]);
+        // The edge table path also reads the indexed input only. When cross
+        // validating it fills edge_topology only, compared after the wait.
+        if (plan.needs(Representation::EdgeTable)) {
+            tasks.run([&]() {
+                PhaseDone done{progress, edge_table_phase};
+                if (gate.skip()) {
+                    return;
+                }
+                Logger::getInstance().log("Building edge table...");
+                edge_topology = TopologyEngine::analyze(mesh);
+                Logger::getInstance().log("Edge table: " + std::to_string(edge_topology.edges_count) + " edges, " +
+                                          std::to_string(edge_topology.border_edges_count) + " border, " +
+                                          std::to_string(edge_topology.non_manifold_edges_count) + " non-manifold");
+                if (halfedge_topology) {
+                    return;
+                }
+                if (checksToPerform.count(CheckType::Watertight)) {
+                    result.is_watertight = edge_topology.is_closed;
+                    gate.record(CheckType::Watertight, !result.is_watertight, true);
+                }
+                if (checksToPerform.count(CheckType::NonManifold)) {
+                    result.non_manifold_vertices_count = static_cast<int>(edge_topology.non_manifold_vertices_count);
+                    result.non_manifold_faces = edge_topology.non_manifold_faces;
+                    gate.record(CheckType::NonManifold, result.non_manifold_vertices_count > 0, true);
+                }
+                if (checksToPerform.count(CheckType::Holes)) {
+                    result.hole_loops = edge_topology.border_loops;
+                    measureHoles(result, [&](unsigned int v) { return vertexPoint(mesh, v); });
+                    result.holes_count = static_cast<int>(result.hole_loops.size());
+                    gate.record(CheckType::Holes, result.holes_count > 0, true);
                 }
-                result.intersecting_faces.assign(intersecting_faces_set.begin(), intersecting_faces_set.end());
-                Logger::getInstance().log("Self-intersections found: " + std::to_string(result.self_intersections_count));
             });
         }
 
-        if (checksToPerform.count(CheckType::Holes)) {
-            threads.emplace_back([&]() {
-                Logger::getInstance().log("Checking for holes...");
-                std::vector<halfedge_descriptor> border_edges;
-                CGAL::Polygon_mesh_processing::border_halfedges(faces(cgal_mesh), cgal_mesh, std::back_inserter(border_edges));
-                
-                result.hole_loops.clear();
-                if (!border_edges.empty()) {
-                    std::map<CGALMesh::Vertex_index, unsigned int> cgal_to_orig_v;
-                    unsigned int v_idx_counter = 0;
-                    for(CGALMesh::Vertex_index vd : vertices(cgal_mesh)) {
-                        cgal_to_orig_v[vd] = v_idx_counter++;
-                    }
+        // Everything else goes through CGAL's halfedge mesh, built from the soup
+        if (plan.needs(Representation::PolygonSoup) && !gate.skip()) {
+            PhaseDone done{progress, conversion_phase};
+            Logger::getInstance().log("Starting mesh conversion to CGAL format...");
+            std::unique_ptr<SoupBuffers> local_buffers;
+            SoupBuffers& buffers = soupBuffers(options.arena, local_buffers);
 
-                    std::map<CGALMesh::Vertex_index, halfedge_descriptor> successor_map;
-                    for(const auto& h : border_edges) {
-                        successor_map[source(h, cgal_mesh)] = h;
-                    }
+            std::vector<Point>& points = buffers.points;
+            points.clear();
+            points.reserve(vertexCount(mesh));
+            for (size_t v = 0; v < vertexCount(mesh); ++v) {
+                points.push_back(vertexPoint(mesh, v));
+            }
 
-                    std::set<CGALMesh::Vertex_index> visited_vertices;
-                    for(const auto& start_v : cgal_to_orig_v) {
-                        if(successor_map.count(start_v.first) && visited_vertices.find(start_v.first) == visited_vertices.end()) {
-                            std::vector<unsigned int> current_loop;
-                            CGALMesh::Vertex_index current_v = start_v.first;
-                            do {
-                                visited_vertices.insert(current_v);
-                                current_loop.push_back(start_v.second);
-                                halfedge_descriptor h = successor_map.at(current_v);
-                                current_v = target(h, cgal_mesh);
-                            } while(current_v != start_v.first && visited_vertices.find(current_v) == visited_vertices.end());
-                            result.hole_loops.push_back(current_loop);
+            std::vector<std::vector<std::size_t>>& polygons = buffers.polygons;
+            polygons.resize(indexCount(mesh) / 3);
+            for (size_t f = 0; f < polygons.size(); ++f) {
+                polygons[f].assign({cornerIndex(mesh, 3 * f), cornerIndex(mesh, 3 * f + 1), cornerIndex(mesh, 3 * f + 2)});
+            }
+            progress.update(conversion_phase, 0.1f);
+            throwIfCancelled(limit);
+
+            // Original face of each polygon when polygons are only filtered
+            std::vector<std::size_t>& polygon_faces = buffers.polygon_faces;
+            polygon_faces.clear();
+
+            try {
+                if (options.repair_soup) {
+                    Logger::getInstance().log("Repairing polygon soup...");
+                    CGAL::Polygon_mesh_processing::repair_polygon_soup(points, polygons);
+                } else {
+                    Logger::getInstance().log("Removing faces collapsed by welding...");
+                    polygon_faces.reserve(polygons.size());
+                    size_t kept = 0;
+                    for (size_t f = 0; f < polygons.size(); ++f) {
+                        const auto& polygon = polygons[f];
+                        if (polygon[0] != polygon[1] && polygon[1] != polygon[2] && polygon[0] != polygon[2]) {
+                            if (kept != f) {
+                                polygons[kept].swap(polygons[f]);
+                            }
+                            ++kept;
+                            polygon_faces.push_back(f);
                         }
                     }
+                    polygons.resize(kept);
                 }
-                result.holes_count = result.hole_loops.size();
-                Logger::getInstance().log("Holes found: " + std::to_string(result.holes_count));
-            });
+                progress.update(conversion_phase, 0.5f);
+                throwIfCancelled(limit);
+                Logger::getInstance().log("Orienting polygon soup...");
+                CGAL::Polygon_mesh_processing::orient_polygon_soup(points, polygons);
+            } catch (const std::exception& e) {
+                Logger::getInstance().log("CGAL Exception during soup processing: " + std::string(e.what()));
+            }
+            progress.update(conversion_phase, 0.8f);
+            throwIfCancelled(limit);
+
+            CGAL::Polygon_mesh_processing::polygon_soup_to_polygon_mesh(points, polygons, cgal_mesh);
+            Logger::getInstance().log("Mesh conversion finished.");
+        
+            // Create a property map to store original face indices
+            bool created;
+            boost::tie(original_face_indices, created) = cgal_mesh.add_property_map<face_descriptor, std::size_t>("f:original_index", 0);
+
+            // We need to re-associate faces in the cgal_mesh with original indices.
+            // This is tricky after soup processing. A robust way is to map vertex indices.
+            // For now, we assume the order is maintained by polygon_soup_to_polygon_mesh.
+            std::size_t face_idx_counter = 0;
+            for(face_descriptor fd : faces(cgal_mesh)) {
+                original_face_indices[fd] = face_idx_counter < polygon_faces.size() ? polygon_faces[face_idx_counter] : face_idx_counter;
+                face_idx_counter++;
+            }
         }
 
-        if (checksToPerform.count(CheckType::DegenerateFaces)) {
-            threads.emplace_back([&]() {
-                Logger::getInstance().log("Checking for degenerate faces with relative tolerance...");
-                result.degenerate_faces_count = 0;
-                const double epsilon_sq = 1e-12; // A small tolerance for the squared ratio
-
-                for(face_descriptor fd : faces(cgal_mesh)) {
-                    auto h = halfedge(fd, cgal_mesh);
-                    const auto& p1 = cgal_mesh.point(source(h, cgal_mesh));
-                    const auto& p2 = cgal_mesh.point(target(h, cgal_mesh));
-                    const auto& p3 = cgal_mesh.point(target(next(h, cgal_mesh), cgal_mesh));
-
-                    K::Vector_3 v1 = p2 - p1;
-                    K::Vector_3 v2 = p3 - p1;
-                    K::Vector_3 v3 = p3 - p2;
-
-                    double a_sq = v1.squared_length();
-                    double b_sq = v2.squared_length();
-                    double c_sq = v3.squared_length();
-
-                    // Avoid division by zero for zero-length edges (which are degenerate)
-                    if (a_sq == 0 || b_sq == 0 || c_sq == 0) {
-                        result.degenerate_faces_count++;
-                        continue;
+        if (plan.needs(Representation::HalfedgeMesh) && !gate.skip()) {
+            if (checksToPerform.count(CheckType::Watertight) && halfedge_topology) {
+                tasks.run([&]() {
+                    PhaseDone done{progress, watertight_phase};
+                    if (gate.skip()) {
+                        return;
                     }
-                    
-                    K::Vector_3 cross_prod = CGAL::cross_product(v1, v2);
-                    double area_sq_x4 = cross_prod.squared_length(); // This is 4 * (triangle area)^2
+                    Logger::getInstance().log("Checking watertightness...");
+                    result.is_watertight = CGAL::is_closed(cgal_mesh);
+                    gate.record(CheckType::Watertight, !result.is_watertight, true);
+                    Logger::getInstance().log(std::string("Watertight: ") + (result.is_watertight ? "Yes" : "No"));
+                });
+            }
 
-                    // Find the longest edge squared
-                    double max_edge_sq = std::max({a_sq, b_sq, c_sq});
+            if (checksToPerform.count(CheckType::NonManifold) && halfedge_topology) {
+                tasks.run([&]() {
+                    PhaseDone done{progress, non_manifold_phase};
+                    if (gate.skip()) {
+                        return;
+                    }
+                    Logger::getInstance().log("Checking non-manifold vertices...");
+                    std::pmr::vector<halfedge_descriptor> non_manifold_halfedges(resource);
+                    const CheckLimit check_limit = gate.startCheck(CheckType::NonManifold);
+                    const bool complete = enumerateLimited(std::back_inserter(non_manifold_halfedges), check_limit, [&](auto output) {
+                        CGAL::Polygon_mesh_processing::non_manifold_vertices(cgal_mesh, output);
+                    });
+                    result.non_manifold_vertices_count = non_manifold_halfedges.size();
+                    gate.record(CheckType::NonManifold, !non_manifold_halfedges.empty(), complete);
+                    gate.finishCheck(CheckType::NonManifold);
+                    std::pmr::set<std::size_t> non_manifold_faces_set(resource);
+                    for (const auto& h : non_manifold_halfedges) {
+                         if(!is_border(h, cgal_mesh))
+                            non_manifold_faces_set.insert(original_face_indices[face(h, cgal_mesh)]);
+                    }
+                    result.non_manifold_faces.assign(non_manifold_faces_set.begin(), non_manifold_faces_set.end());
+                    Logger::getInstance().log("Non-manifold vertices found: " + std::to_string(result.non_manifold_vertices_count));
+                });
+            }
 
-                    // Check if area is negligible compared to the longest edge
-                    if (area_sq_x4 / max_edge_sq < epsilon_sq) {
-                        result.degenerate_faces_count++;
+            if (checksToPerform.count(CheckType::SelfIntersect)) {
+                tasks.run([&]() {
+                    PhaseDone done{progress, self_intersection_phase};
+                    if (gate.skip()) {
+                        return;
                     }
-                }
-                Logger::getInstance().log("Degenerate faces found: " + std::to_string(result.degenerate_faces_count));
-            });
+                    Logger::getInstance().log("Checking self-intersections...");
+                    std::pmr::vector<std::pair<face_descriptor, face_descriptor>> self_intersections(resource);
+                    const CheckLimit check_limit = gate.startCheck(CheckType::SelfIntersect);
+                    bool complete;
+                    if (options.parallel_self_intersections) {
+                        complete = TrianglePairs::selfIntersections(cgal_mesh, std::back_inserter(self_intersections),
+                                                                    progress.phaseLimit(check_limit, self_intersection_phase));
+                    } else {
+                        complete = enumerateLimited(std::back_inserter(self_intersections), check_limit, [&](auto output) {
+                            CGAL::Polygon_mesh_processing::self_intersections(cgal_mesh, output);
+                        });
+                    }
+                    result.self_intersections_count = self_intersections.size();
+                    gate.record(CheckType::SelfIntersect, !self_intersections.empty(), complete);
+                    gate.finishCheck(CheckType::SelfIntersect);
+                    std::pmr::set<std::size_t> intersecting_faces_set(resource);
+                    for(const auto& pair : self_intersections) {
+                        intersecting_faces_set.insert(original_face_indices[pair.first]);
+                        intersecting_faces_set.insert(original_face_indices[pair.second]);
+                    }
+                    result.intersecting_faces.assign(intersecting_faces_set.begin(), intersecting_faces_set.end());
+                    Logger::getInstance().log("Self-intersections found: " + std::to_string(result.self_intersections_count));
+                });
+            }
+
+            if (checksToPerform.count(CheckType::Holes) && halfedge_topology) {
+                tasks.run([&]() {
+                    PhaseDone done{progress, holes_phase};
+                    if (gate.skip()) {
+                        return;
+                    }
+                    Logger::getInstance().log("Checking for holes...");
+                    // The mesh is freshly built, so halfedge indices are dense
+                    // and index a flat array directly. next() of a border
+                    // halfedge is the next border halfedge of its hole.
+                    std::pmr::vector<unsigned char> walked(cgal_mesh.number_of_halfedges(), 0, resource);
+                    // Loops hold input vertex indices, as the edge table's do
+                    InputVertexLookup<MeshType> input_vertices(mesh);
+                    const CheckLimit check_limit = gate.startCheck(CheckType::Holes);
+                    result.hole_loops.clear();
+                    for (halfedge_descriptor start : halfedges(cgal_mesh)) {
+                        if (walked[start.idx()] || !cgal_mesh.is_border(start)) {
+                            continue;
+                        }
+                        if (check_limit.shouldStop(result.hole_loops.size())) {
+                            break;
+                        }
+                        std::vector<unsigned int> loop;
+                        halfedge_descriptor h = start;
+                        do {
+                            walked[h.idx()] = 1;
+                            const vertex_descriptor source = cgal_mesh.source(h);
+                            unsigned int input_vertex;
+                            if (input_vertices.find(source.idx(), cgal_mesh.point(source), input_vertex)) {
+                                loop.push_back(input_vertex);
+                            }
+                            h = cgal_mesh.next(h);
+                        } while (h != start);
+                        result.hole_loops.push_back(std::move(loop));
+                    }
+                    measureHoles(result, [&](unsigned int v) { return vertexPoint(mesh, v); });
+                    result.holes_count = result.hole_loops.size();
+                    gate.recordCount(CheckType::Holes, result.holes_count);
+                    gate.finishCheck(CheckType::Holes);
+                    Logger::getInstance().log("Holes found: " + std::to_string(result.holes_count));
+                });
+            }
         }
 
-        threads.emplace_back([&]() {
-            Logger::getInstance().log("Checking UVs...");
-            result.has_uvs = UvChecker::hasUvs(mesh);
-            Logger::getInstance().log(std::string("Has UVs: ") + (result.has_uvs ? "Yes" : "No"));
-            if (result.has_uvs) {
-                if (checksToPerform.count(CheckType::UVOverlap)) {
-                    Logger::getInstance().log("Checking for overlapping UVs...");
-                    result.overlapping_uv_islands_count = UvChecker::countOverlappingUvIslands(mesh, result.overlapping_uv_faces);
-                    Logger::getInstance().log("Overlapping UV islands found: " + std::to_string(result.overlapping_uv_islands_count));
+        if (plan.needs(Representation::UvMesh)) {
+            tasks.run([&]() {
+                PhaseDone done{progress, uv_phase};
+                if (gate.skip()) {
+                    return;
                 }
-                if (checksToPerform.count(CheckType::UVBounds)) {
-                    Logger::getInstance().log("Checking for UVs out of bounds...");
-                    result.uvs_out_of_bounds_count = UvChecker::countUvsOutOfBounds(mesh);
-                    Logger::getInstance().log("UVs out of bounds found: " + std::to_string(result.uvs_out_of_bounds_count));
+                Logger::getInstance().log("Checking UVs...");
+                result.has_uvs = uv_mesh && UvChecker::hasUvs(*uv_mesh);
+                Logger::getInstance().log(std::string("Has UVs: ") + (result.has_uvs ? "Yes" : "No"));
+                if (result.has_uvs) {
+                    if (checksToPerform.count(CheckType::UVOverlap) && !gate.skip()) {
+                        Logger::getInstance().log("Checking for overlapping UVs...");
+                        const CheckLimit check_limit = gate.startCheck(CheckType::UVOverlap);
+                        result.overlapping_uv_islands_count = UvChecker::countOverlappingUvIslands(*uv_mesh, result.overlapping_uv_faces, options.arena,
+                                                                                                  progress.phaseLimit(check_limit, uv_phase));
+                        gate.recordCount(CheckType::UVOverlap, result.overlapping_uv_faces.size());
+                        gate.finishCheck(CheckType::UVOverlap);
+                        Logger::getInstance().log("Overlapping UV islands found: " + std::to_string(result.overlapping_uv_islands_count));
+                    }
+                    if (checksToPerform.count(CheckType::UVBounds) && !gate.skip()) {
+                        Logger::getInstance().log("Checking for UVs out of bounds...");
+                        const CheckLimit check_limit = gate.startCheck(CheckType::UVBounds);
+                        result.uvs_out_of_bounds_count = UvChecker::countUvsOutOfBounds(*uv_mesh, check_limit);
+                        gate.recordCount(CheckType::UVBounds, result.uvs_out_of_bounds_count);
+                        gate.finishCheck(CheckType::UVBounds);
+                        Logger::getInstance().log("UVs out of bounds found: " + std::to_string(result.uvs_out_of_bounds_count));
+                    }
+                } else {
+                    // Nothing to check: both UV checks are done
+                    for (CheckType check : {CheckType::UVOverlap, CheckType::UVBounds}) {
+                        if (checksToPerform.count(check)) {
+                            gate.record(check, false, true);
+                        }
+                    }
                 }
-            }
-        });
-
-        for (auto& thread : threads) {
-            thread.join();
+            });
         }
 
+        tasks.wait();
         cgal_mesh.clear();
+        result.stopped_early = gate.stopped;
+        result.completed_checks = gate.completed;
+        result.timed_out_checks = gate.timed_out;
+
+        if (options.topology == MeshCheckOptions::Topology::CrossValidate && !result.stopped_early) {
+            crossValidateTopology(result, edge_topology, checksToPerform);
+        }
 
+    } catch (const CheckCancelled&) {
+        // The task group has waited for the running checks to stop
     } catch (const std::exception& e) {
         Logger::getInstance().log("CGAL Exception: " + std::string(e.what()));
     } catch (...) {
         Logger::getInstance().log("An unknown exception occurred during mesh check.");
     }
 
+    if (options.cancel && options.cancel->load()) {
+        result.cancelled = true;
+        result.stopped_early = true;
+        Logger::getInstance().log("Mesh check cancelled.");
+    }
     return result;
 }
 
+} // namespace
+
+MeshChecker::CheckResult MeshChecker::check(const Mesh& mesh, const std::set<CheckType>& checksToPerform, const MeshCheckOptions& options)
+{
+    return checkMesh(mesh, &mesh, checksToPerform, options);
+}
+
+MeshChecker::CheckResult MeshChecker::check(const CompactMesh& mesh, const std::set<CheckType>& checksToPerform, const MeshCheckOptions& options)
+{
+    return checkMesh(mesh, nullptr, checksToPerform, options);
+}
+
+bool MeshChecker::passes(const CheckResult& result, const std::set<CheckType>& checksToPerform)
+{
+    for (CheckType check : checksToPerform) {
+        if (result.timed_out_checks.count(check)) {
+            return false;
+        }
+        switch (check) {
+        case CheckType::Watertight:
+            if (!result.is_watertight) return false;
+            break;
+        case CheckType::NonManifold:
+            if (result.non_manifold_vertices_count > 0) return false;
+            break;
+        case CheckType::SelfIntersect:
+            if (result.self_intersections_count > 0) return false;
+            break;
+        case CheckType::Holes:
+            if (result.holes_count > 0) return false;
+            break;
+        case CheckType::DegenerateFaces:
+            if (result.degenerate_faces_count > 0) return false;
+            break;
+        case CheckType::UVOverlap:
+            if (result.overlapping_uv_islands_count > 0) return false;
+            break;
+        case CheckType::UVBounds:
+            if (result.uvs_out_of_bounds_count > 0) return false;
+            break;
+        }
+    }
+    return true;
+}
+
+const char* MeshChecker::checkName(CheckType check)
+{
+    switch (check) {
+    case CheckType::Watertight: return "Watertight";
+    case CheckType::NonManifold: return "NonManifoldVertices";
+    case CheckType::SelfIntersect: return "SelfIntersections";
+    case CheckType::Holes: return "Holes";
+    case CheckType::DegenerateFaces: return "DegenerateFaces";
+    case CheckType::UVOverlap: return "OverlappingUVs";
+    case CheckType::UVBounds: return "UVsOutOfBounds";
+    }
+    return "";
+}
+
 #include "MeshChecker.h"
 #include "UvChecker.h"
 #include "Logger.h"
@@ -276,44 +1235,108 @@ typedef CGALMesh::Halfedge_index halfedge_descriptor;
 
 
 
-bool MeshChecker::intersects(const Mesh& mesh1, const Mesh& mesh2, std::vector<int>& intersecting_faces)
+MeshLoadOptions MeshChecker::requiredAttributes(const std::set<CheckType>& checksToPerform)
+{
+    MeshLoadOptions options;
+    // Only the UV checks read anything beyond positions and vertex indices
+    options.keep_uvs = checksToPerform.count(CheckType::UVOverlap) || checksToPerform.count(CheckType::UVBounds);
+    options.keep_normals = false;
+    return options;
+}
+
+namespace {
+
+// Exact, float and box copies of a triangle list, and the faces that are
+// not degenerate. Degenerate faces have no well-defined intersection test
+// and are skipped.
+struct TriangleSet {
+    std::vector<ExactTriangle> exact;
+    std::vector<TriangleFilter::Triangle> filter;
+    std::vector<TrianglePairs::Box> boxes;
+    std::vector<unsigned int> valid;
+
+    void assign(const std::vector<Triangle>& triangles)
+    {
+        const size_t count = triangles.size();
+        exact.resize(count);
+        filter.resize(count);
+        boxes.resize(count);
+        std::vector<unsigned char> degenerate(count);
+        Parallel::forRange(count, 1 << 14, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                const Triangle& t = triangles[i];
+                exact[i] = ExactTriangle(TrianglePairs::exactPoint(t[0]), TrianglePairs::exactPoint(t[1]), TrianglePairs::exactPoint(t[2]));
+                filter[i] = TrianglePairs::filterTriangle(t);
+                boxes[i] = TrianglePairs::triangleBox(t);
+                degenerate[i] = exact[i].is_degenerate();
+            }
+        });
+        valid.clear();
+        for (size_t i = 0; i < count; ++i) {
+            if (!degenerate[i]) {
+                valid.push_back(static_cast<unsigned int>(i));
+            }
+        }
+    }
+};
+
+template <typename MeshType>
+bool intersectMeshes(const MeshType& mesh1, const MeshType& mesh2, std::vector<int>& intersecting_faces)
 {
     try {
         Logger::getInstance().log("Building triangle lists for intersection check...");
 
         // --- Process Mesh 1 (Mannequin) ---
         std::vector<Triangle> triangles1;
-        triangles1.reserve(mesh1.vertex_indices.size() / 3);
-        for (size_t i = 0; i < mesh1.vertex_indices.size(); i += 3) {
-            const auto& p1 = mesh1.vertices[mesh1.vertex_indices[i]];
-            const auto& p2 = mesh1.vertices[mesh1.vertex_indices[i+1]];
-            const auto& p3 = mesh1.vertices[mesh1.vertex_indices[i+2]];
-            triangles1.emplace_back(Point(p1.x, p1.y, p1.z), Point(p2.x, p2.y, p2.z), Point(p3.x, p3.y, p3.z));
-        }
+        buildTriangles(mesh1, triangles1);
+        TriangleSet set1;
+        set1.assign(triangles1);
 
         // --- Process Mesh 2 (Apparel) ---
         std::vector<Triangle> triangles2;
-        triangles2.reserve(mesh2.vertex_indices.size() / 3);
-        for (size_t i = 0; i < mesh2.vertex_indices.size(); i += 3) {
-            const auto& p1 = mesh2.vertices[mesh2.vertex_indices[i]];
-            const auto& p2 = mesh2.vertices[mesh2.vertex_indices[i+1]];
-            const auto& p3 = mesh2.vertices[mesh2.vertex_indices[i+2]];
-            triangles2.emplace_back(Point(p1.x, p1.y, p1.z), Point(p2.x, p2.y, p2.z), Point(p3.x, p3.y, p3.z));
+        buildTriangles(mesh2, triangles2);
+        TriangleSet set2;
+        set2.assign(triangles2);
+
+        intersecting_faces.clear();
+        if (set1.valid.empty() || set2.valid.empty()) {
+            return false;
         }
 
-        Logger::getInstance().log("Building AABB tree for mannequin...");
-        Tree tree1(triangles1.begin(), triangles1.end());
-        tree1.accelerate_distance_queries();
+        Logger::getInstance().log("Building bounding volume hierarchy for mannequin...");
+        TrianglePairs::Hierarchy hierarchy;
+        hierarchy.build(set1.boxes, set1.valid);
 
-        intersecting_faces.clear();
         Logger::getInstance().log("Checking apparel faces for intersection...");
-        for(size_t i = 0; i < triangles2.size(); ++i) {
-            if(tree1.do_intersect(triangles2[i])) {
-                intersecting_faces.push_back(i);
-            }
+        std::vector<unsigned char> hit(triangles2.size(), 0);
+        TaskGroup tasks;
+        for (size_t block = 0; block < set2.valid.size(); block += TrianglePairs::QUERY_BLOCK) {
+            tasks.run([&, block]() {
+                // Pairs are (mannequin face, apparel face)
+                std::vector<std::pair<unsigned int, unsigned int>> candidates;
+                candidates.reserve(TrianglePairs::FILTER_BATCH);
+                auto exact = [&](const std::pair<unsigned int, unsigned int>& pair) {
+                    if (!hit[pair.second] && CGAL::do_intersect(set1.exact[pair.first], set2.exact[pair.second])) {
+                        hit[pair.second] = 1;
+                    }
+                };
+                for (size_t i = block; i < std::min(set2.valid.size(), block + TrianglePairs::QUERY_BLOCK); ++i) {
+                    const unsigned int a = set2.valid[i];
+                    hierarchy.query(set2.boxes[a], 0, [&](size_t j) {
+                        candidates.emplace_back(hierarchy.faces[j], a);
+                    });
+                    // Per face, so a hit skips the face's remaining exact tests
+                    TrianglePairs::filterPairs(set1.filter, set2.filter, candidates, exact);
+                }
+            });
         }
+        tasks.wait();
 
-        tree1.clear();
+        for (size_t i = 0; i < hit.size(); ++i) {
+            if (hit[i]) {
+                intersecting_faces.push_back(static_cast<int>(i));
+            }
+        }
 
         Logger::getInstance().log("Found " + std::to_string(intersecting_faces.size()) + " intersecting faces on apparel.");
         return !intersecting_faces.empty();
@@ -327,6 +1350,18 @@ bool MeshChecker::intersects(const Mesh& mesh1, const Mesh& mesh2, std::vector<i
     }
 }
 
+} // namespace
+
+bool MeshChecker::intersects(const Mesh& mesh1, const Mesh& mesh2, std::vector<int>& intersecting_faces)
+{
+    return intersectMeshes(mesh1, mesh2, intersecting_faces);
+}
+
+bool MeshChecker::intersects(const CompactMesh& mesh1, const CompactMesh& mesh2, std::vector<int>& intersecting_faces)
+{
+    return intersectMeshes(mesh1, mesh2, intersecting_faces);
+}
+
 
 
 
@@ -2,9 +2,74 @@
 #define MESHCHECKER_H
 
 #include "Mesh.h"
+#include "ObjLoader.h"
+#include "DegenerateChecker.h"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
 #include <vector>
 #include <set>
 
+class WorkerArena;
+struct CompactMesh;
+
+struct MeshCheckOptions {
+    // Where watertightness, non-manifold vertices and holes are computed
+    enum class Topology {
+        HalfedgeMesh,  // CGAL Surface_mesh built from the repaired soup
+        EdgeTable,     // TopologyEngine on the indexed input, no CGAL mesh
+        CrossValidate  // Both; reports the halfedge mesh results and logs
+                       // where the edge table disagrees
+    };
+
+    // Merge duplicate points and drop degenerate polygons with CGAL before
+    // building the surface mesh. Meshes welded at load time (see Welder) only
+    // need the faces the weld collapsed removed, which is done without it.
+    bool repair_soup = true;
+
+    // Find self-intersections with the BVH traversal split across the task
+    // scheduler, a float pre-test and exact predicates. Off runs CGAL's
+    // sequential self_intersections on the inexact kernel, for cross-checking.
+    bool parallel_self_intersections = true;
+
+    Topology topology = Topology::HalfedgeMesh;
+
+    // What the DegenerateFaces check counts as degenerate or a sliver
+    DegenerateThresholds degenerate_thresholds;
+
+    // Gate mode: each check stops enumerating after this many violations
+    // (0 lists them all), and with stop_on_failure the checks still running
+    // stop, and the ones not yet started are skipped, once any check fails.
+    size_t violation_limit = 0;
+    bool stop_on_failure = false;
+
+    // Set from any thread to cancel the check. The checks look at it inside
+    // their long loops and between the soup conversion stages, and check()
+    // returns soon after with CheckResult::cancelled set. CGAL's soup repair
+    // itself cannot be interrupted, and the CGAL enumerations (non-manifold
+    // vertices, and self-intersections with parallel_self_intersections off)
+    // only see it when they report a violation, so they may run to the end.
+    const std::atomic<bool>* cancel = nullptr;
+
+    // Time each check may take, counted from when it starts; zero is no
+    // limit. A check that sees its deadline pass stops, keeps what it has
+    // found and is listed in CheckResult::timed_out_checks. Watertightness,
+    // the edge table and the soup conversion are linear and not limited.
+    // CGAL's sequential self_intersections only sees the deadline when it
+    // reports a pair.
+    std::chrono::milliseconds check_time_budget{0};
+
+    // Called with the phase that advanced and the fraction of the whole
+    // check done, at most once per 0.1%. Checks run in parallel, so it is
+    // called from worker threads, though never twice at the same time.
+    std::function<void(const std::string& phase, float fraction)> progress;
+
+    // Scratch memory reused across calls by a batch worker. Null allocates
+    // everything per call.
+    WorkerArena* arena = nullptr;
+};
+
 class MeshChecker
 {
 public:
@@ -18,6 +83,15 @@ public:
         UVBounds
     };
 
+    // Size of one hole, for looking at the largest holes first
+    struct HoleMetrics {
+        float perimeter = 0.0f;
+        // Length of the loop's vector area: the area for planar holes and a
+        // lower bound for curved ones
+        float area = 0.0f;
+        BoundingBox bounds;
+    };
+
     struct CheckResult {
         bool is_watertight = false;
         int non_manifold_vertices_count;
@@ -27,11 +101,23 @@ public:
         bool has_uvs;
         int overlapping_uv_islands_count;
         int uvs_out_of_bounds_count;
+        // Some counts are lower bounds: a check hit the violation limit, ran
+        // out of time, or was stopped or skipped after another check failed
+        bool stopped_early = false;
+        bool cancelled = false; // Through MeshCheckOptions::cancel
+        // Checks that saw the whole mesh. After a stop or a cancel, the
+        // results of the others are partial or were never computed.
+        std::set<CheckType> completed_checks;
+        // Checks stopped at MeshCheckOptions::check_time_budget; their
+        // counts are lower bounds
+        std::set<CheckType> timed_out_checks;
 
         // For visualization
         std::vector<unsigned int> intersecting_faces;
         std::vector<unsigned int> non_manifold_faces;
-        std::vector<std::vector<unsigned int>> hole_loops;
+        std::vector<unsigned int> degenerate_faces;
+        std::vector<std::vector<unsigned int>> hole_loops; // Input vertex indices around each hole
+        std::vector<HoleMetrics> hole_metrics; // One per hole loop
         std::vector<unsigned int> overlapping_uv_faces;
 
         void clear() {
@@ -43,15 +129,34 @@ public:
             has_uvs = false;
             overlapping_uv_islands_count = 0;
             uvs_out_of_bounds_count = 0;
+            stopped_early = false;
+            cancelled = false;
+            completed_checks.clear();
+            timed_out_checks.clear();
             intersecting_faces.clear();
             non_manifold_faces.clear();
+            degenerate_faces.clear();
             hole_loops.clear();
+            hole_metrics.clear();
             overlapping_uv_faces.clear();
         }
     };
 
-    static CheckResult check(const Mesh& mesh, const std::set<CheckType>& checksToPerform);
+    static CheckResult check(const Mesh& mesh, const std::set<CheckType>& checksToPerform, const MeshCheckOptions& options = MeshCheckOptions());
+    // Same checks on a compact mesh. It has no UVs, so the UV checks report
+    // has_uvs = false.
+    static CheckResult check(const CompactMesh& mesh, const std::set<CheckType>& checksToPerform, const MeshCheckOptions& options = MeshCheckOptions());
+    // Minimal set of attributes the given checks read, for loading meshes that
+    // are only going to be checked.
+    static MeshLoadOptions requiredAttributes(const std::set<CheckType>& checksToPerform);
+    // True if none of the given checks found a violation. A missing UV set
+    // fails neither UV check; a check that timed out fails, as it may have
+    // missed violations.
+    static bool passes(const CheckResult& result, const std::set<CheckType>& checksToPerform);
+    // Short name of a check, as used for the batch CSV columns
+    static const char* checkName(CheckType check);
     static bool intersects(const Mesh& mesh1, const Mesh& mesh2, std::vector<int>& intersecting_faces);
+    static bool intersects(const CompactMesh& mesh1, const CompactMesh& mesh2, std::vector<int>& intersecting_faces);
 };
 
 #endif // MESHCHECKER_H
@@ -0,0 +1,70 @@
+#include "MeshFingerprint.h"
+#include "Hash.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+// Bytes hashed per task; the same for every array so the result does not
+// depend on the thread count.
+const size_t FINGERPRINT_BLOCK_SIZE = 1 << 20;
+
+// Distinct seeds keep e.g. positions and UVs with the same bytes apart
+enum ArraySeed : uint64_t {
+    POSITIONS_SEED = 1,
+    VERTEX_INDICES_SEED,
+    UVS_SEED,
+    UV_INDICES_SEED
+};
+
+uint64_t hashArray(const void* data, size_t length, uint64_t seed)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    const size_t num_blocks = (length + FINGERPRINT_BLOCK_SIZE - 1) / FINGERPRINT_BLOCK_SIZE;
+    std::vector<uint64_t> block_hashes(num_blocks);
+    Parallel::forRange(num_blocks, 1, [&](size_t begin, size_t end) {
+        for (size_t b = begin; b < end; ++b) {
+            const size_t offset = b * FINGERPRINT_BLOCK_SIZE;
+            block_hashes[b] = Hash::xxh64(bytes + offset, std::min(FINGERPRINT_BLOCK_SIZE, length - offset), seed);
+        }
+    });
+    // The length goes into the seed so arrays of only empty blocks still differ
+    return Hash::xxh64(block_hashes.data(), block_hashes.size() * sizeof(uint64_t), seed ^ length);
+}
+
+template <typename T>
+uint64_t hashVector(const std::vector<T>& values, uint64_t seed)
+{
+    return hashArray(values.data(), values.size() * sizeof(T), seed);
+}
+
+} // namespace
+
+MeshFingerprint MeshFingerprint::compute(const Mesh& mesh)
+{
+    const uint64_t vertex_count = mesh.vertices.size();
+    const uint64_t vertex_indices_hash = hashVector(mesh.vertex_indices, VERTEX_INDICES_SEED);
+
+    const uint64_t topology[] = {vertex_count, vertex_indices_hash};
+    const uint64_t geometry[] = {
+        hashVector(mesh.vertices, POSITIONS_SEED),
+        vertex_indices_hash,
+        hashVector(mesh.uvs, UVS_SEED),
+        hashVector(mesh.uv_indices, UV_INDICES_SEED)
+    };
+
+    MeshFingerprint fingerprint;
+    fingerprint.topology = Hash::xxh64(topology, sizeof(topology));
+    fingerprint.geometry = Hash::xxh64(geometry, sizeof(geometry));
+    return fingerprint;
+}
+
+std::string MeshFingerprint::toString() const
+{
+    char text[34];
+    std::snprintf(text, sizeof(text), "%016llx:%016llx",
+                  static_cast<unsigned long long>(geometry), static_cast<unsigned long long>(topology));
+    return text;
+}
@@ -0,0 +1,38 @@
+#ifndef MESHFINGERPRINT_H
+#define MESHFINGERPRINT_H
+
+#include "Mesh.h"
+#include <cstdint>
+#include <string>
+
+// Content hashes of a loaded mesh, independent of file name, path and format.
+//
+// 'geometry' covers positions, vertex indices, UVs and UV indices, so two
+// meshes with equal geometry hashes check identically. 'topology' covers only
+// the vertex count and vertex indices and stays the same when vertices move.
+// Colors and normals are left out; they do not affect any check.
+struct MeshFingerprint
+{
+    uint64_t geometry = 0;
+    uint64_t topology = 0;
+
+    // Hashes fixed-size blocks of each array in parallel, then the block hashes.
+    static MeshFingerprint compute(const Mesh& mesh);
+
+    // "<geometry>:<topology>" in hex
+    std::string toString() const;
+
+    bool operator==(const MeshFingerprint& other) const {
+        return geometry == other.geometry && topology == other.topology;
+    }
+    bool operator!=(const MeshFingerprint& other) const { return !(*this == other); }
+};
+
+struct MeshFingerprintHasher
+{
+    size_t operator()(const MeshFingerprint& fingerprint) const {
+        return static_cast<size_t>(fingerprint.geometry ^ (fingerprint.topology * 0x9E3779B97F4A7C15ull));
+    }
+};
+
+#endif // MESHFINGERPRINT_H
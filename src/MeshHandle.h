@@ -0,0 +1,29 @@
+#ifndef MESHHANDLE_H
+#define MESHHANDLE_H
+
+#include "Mesh.h"
+#include <memory>
+#include <utility>
+#include <vector>
+
+// Shared, immutable mesh geometry. The GUI, the viewer and background check
+// tasks hold handles to the same Mesh instead of copies; it is freed when the
+// last holder lets go. Anything that differs per view, such as highlight
+// colors, lives next to the handle rather than in the Mesh.
+using MeshHandle = std::shared_ptr<const Mesh>;
+
+// Takes over the mesh buffers without copying them.
+inline MeshHandle makeMeshHandle(Mesh&& mesh)
+{
+    return std::make_shared<const Mesh>(std::move(mesh));
+}
+
+// A mesh as one view draws it.
+struct MeshView
+{
+    MeshHandle mesh;
+    // Per-vertex colors owned by the view's owner; null uses mesh->colors
+    const std::vector<glm::vec3>* colors = nullptr;
+};
+
+#endif // MESHHANDLE_H
@@ -0,0 +1,172 @@
+#include "MeshLoader.h"
+#include "CompressedFile.h"
+#include "GltfLoader.h"
+#include "PlyLoader.h"
+#include "StlLoader.h"
+#include "Welder.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+
+namespace fs = std::filesystem;
+
+// Bytes read from the start of a file for format detection
+const size_t PROBE_SIZE = 512;
+
+static std::mutex s_registry_mutex;
+
+static std::vector<std::string> objExtensions()
+{
+    std::vector<std::string> extensions = {".obj", ".obj.gz"};
+    if (CompressedFile::isAvailable(CompressedFile::Codec::Zstd)) {
+        extensions.push_back(".obj.zst");
+    }
+    return extensions;
+}
+
+static std::vector<MeshLoader::Format>& registry()
+{
+    static std::vector<MeshLoader::Format> formats = {
+        {
+            "Wavefront OBJ", objExtensions(),
+            nullptr,
+            [](const std::string& path, Mesh& mesh, const MeshLoadOptions& options) {
+                return ObjLoader::load_shared(path, mesh, options);
+            }
+        },
+        {
+            "PLY", {".ply"},
+            [](const char* data, size_t size, size_t) {
+                return size >= 4 && std::memcmp(data, "ply", 3) == 0 && (data[3] == '\n' || data[3] == '\r');
+            },
+            &PlyLoader::load
+        },
+        {
+            "STL", {".stl"},
+            [](const char* data, size_t size, size_t file_size) {
+                // Binary STL has no signature; the record count must match the file size
+                return size >= 84 && StlLoader::isBinaryStl(data, file_size);
+            },
+            &StlLoader::load
+        },
+        {
+            "glTF", {".glb", ".gltf"},
+            [](const char* data, size_t size, size_t) {
+                return GltfLoader::isGlb(data, size);
+            },
+            &GltfLoader::load
+        }
+    };
+    return formats;
+}
+
+static std::string lowerCase(std::string text)
+{
+    std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return text;
+}
+
+static bool hasExtension(const std::string& lower_path, const std::string& extension)
+{
+    return lower_path.size() > extension.size() &&
+           lower_path.compare(lower_path.size() - extension.size(), extension.size(), extension) == 0;
+}
+
+void MeshLoader::registerFormat(const Format& format)
+{
+    std::lock_guard<std::mutex> lock(s_registry_mutex);
+    registry().push_back(format);
+}
+
+bool MeshLoader::isSupported(const std::string& path)
+{
+    std::string lower_path = lowerCase(path);
+    std::lock_guard<std::mutex> lock(s_registry_mutex);
+    for (const auto& format : registry()) {
+        for (const auto& extension : format.extensions) {
+            if (hasExtension(lower_path, extension)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+std::vector<std::string> MeshLoader::nameFilters()
+{
+    std::vector<std::string> filters;
+    std::lock_guard<std::mutex> lock(s_registry_mutex);
+    for (const auto& format : registry()) {
+        for (const auto& extension : format.extensions) {
+            filters.push_back("*" + extension);
+        }
+    }
+    return filters;
+}
+
+bool MeshLoader::load(const std::string& path, Mesh& mesh, const MeshLoadOptions& options, size_t* welded_vertices)
+{
+    if (welded_vertices) {
+        *welded_vertices = 0;
+    }
+
+    char probe_data[PROBE_SIZE];
+    size_t probe_size = 0;
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            std::cerr << "MeshLoader: cannot open " << path << std::endl;
+            return false;
+        }
+        file.read(probe_data, PROBE_SIZE);
+        probe_size = static_cast<size_t>(file.gcount());
+    }
+    std::error_code ec;
+    size_t file_size = static_cast<size_t>(fs::file_size(path, ec));
+
+    Format selected;
+    {
+        std::lock_guard<std::mutex> lock(s_registry_mutex);
+        // Magic bytes take precedence over a possibly wrong extension
+        for (const auto& format : registry()) {
+            if (format.probe && format.probe(probe_data, probe_size, file_size)) {
+                selected = format;
+                break;
+            }
+        }
+        if (!selected.load) {
+            std::string lower_path = lowerCase(path);
+            size_t best_length = 0;
+            for (const auto& format : registry()) {
+                for (const auto& extension : format.extensions) {
+                    if (extension.size() > best_length && hasExtension(lower_path, extension)) {
+                        selected = format;
+                        best_length = extension.size();
+                    }
+                }
+            }
+        }
+    }
+
+    if (!selected.load) {
+        std::cerr << "MeshLoader: unsupported file format: " << path << std::endl;
+        return false;
+    }
+    if (!selected.load(path, mesh, options)) {
+        return false;
+    }
+
+    if (options.weld_epsilon >= 0.0f) {
+        size_t merged = Welder::weld(mesh, options.weld_epsilon);
+        Logger::getInstance().log("Welded " + std::to_string(merged) + " vertices in " + path);
+        if (welded_vertices) {
+            *welded_vertices = merged;
+        }
+    }
+    return true;
+}
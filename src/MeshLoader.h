@@ -0,0 +1,37 @@
+#ifndef MESHLOADER_H
+#define MESHLOADER_H
+
+#include "Mesh.h"
+#include "ObjLoader.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+// Registry of mesh file formats. A file is matched first by its magic bytes
+// and then by its extension, and loaded with shared vertex indices where the
+// format has them.
+class MeshLoader
+{
+public:
+    struct Format {
+        std::string name;
+        std::vector<std::string> extensions; // Lower case, including the dot
+        // Returns true if the leading bytes identify this format. May be empty
+        // for formats without a reliable signature.
+        std::function<bool(const char* data, size_t size, size_t file_size)> probe;
+        std::function<bool(const std::string& path, Mesh& mesh, const MeshLoadOptions& options)> load;
+    };
+
+    static void registerFormat(const Format& format);
+
+    // Runs the weld stage when options.weld_epsilon >= 0 and reports the
+    // number of merged vertices through welded_vertices if given.
+    static bool load(const std::string& path, Mesh& mesh, const MeshLoadOptions& options = MeshLoadOptions(),
+                     size_t* welded_vertices = nullptr);
+    static bool isSupported(const std::string& path);
+
+    // Wildcard patterns such as "*.obj" for directory scans and file dialogs.
+    static std::vector<std::string> nameFilters();
+};
+
+#endif // MESHLOADER_H
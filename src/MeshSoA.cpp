@@ -0,0 +1,222 @@
+#include "MeshSoA.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MESHSOA_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+// Elements per task for the parallel kernels
+const size_t SOA_GRAIN = 1 << 16;
+
+// Min/max of values[begin, end) folded into lo/hi. NaNs are skipped, as with
+// std::min/std::max in Mesh::getBoundingBox.
+void minMaxRange(const float* values, size_t begin, size_t end, float& lo, float& hi)
+{
+    size_t i = begin;
+#ifdef MESHSOA_SSE2
+    if (end - begin >= 8) {
+        __m128 lo4 = _mm_set1_ps(lo);
+        __m128 hi4 = _mm_set1_ps(hi);
+        for (; i + 4 <= end; i += 4) {
+            const __m128 value = _mm_loadu_ps(values + i);
+            // minps/maxps return the second operand when either is NaN
+            lo4 = _mm_min_ps(value, lo4);
+            hi4 = _mm_max_ps(value, hi4);
+        }
+        float los[4], his[4];
+        _mm_storeu_ps(los, lo4);
+        _mm_storeu_ps(his, hi4);
+        for (int k = 0; k < 4; ++k) {
+            lo = std::min(lo, los[k]);
+            hi = std::max(hi, his[k]);
+        }
+    }
+#endif
+    for (; i < end; ++i) {
+        lo = std::min(lo, values[i]);
+        hi = std::max(hi, values[i]);
+    }
+}
+
+int countDegenerateRange(const MeshSoA& mesh, size_t begin, size_t end, const DegenerateChecker::Bounds& bounds)
+{
+    const unsigned int* indices = mesh.vertex_indices.data();
+    const float* X = mesh.x.data();
+    const float* Y = mesh.y.data();
+    const float* Z = mesh.z.data();
+    int count = 0;
+    size_t f = begin;
+
+#ifdef MESHSOA_SSE2
+    // Two faces per iteration in double precision, the same arithmetic as
+    // DegenerateChecker::isDegenerate
+    const __m128d zero = _mm_setzero_pd();
+    const __m128d height_epsilon = _mm_set1_pd(bounds.height_epsilon_sq);
+    const __m128d min_area = _mm_set1_pd(bounds.area_sq_x4);
+    const __m128d aspect = _mm_set1_pd(bounds.aspect_sq);
+    for (; f + 2 <= end; f += 2) {
+        const unsigned int* a = indices + 3 * f;
+        const unsigned int* b = a + 3;
+        const __m128d x0 = _mm_set_pd(X[b[0]], X[a[0]]), y0 = _mm_set_pd(Y[b[0]], Y[a[0]]), z0 = _mm_set_pd(Z[b[0]], Z[a[0]]);
+        const __m128d x1 = _mm_set_pd(X[b[1]], X[a[1]]), y1 = _mm_set_pd(Y[b[1]], Y[a[1]]), z1 = _mm_set_pd(Z[b[1]], Z[a[1]]);
+        const __m128d x2 = _mm_set_pd(X[b[2]], X[a[2]]), y2 = _mm_set_pd(Y[b[2]], Y[a[2]]), z2 = _mm_set_pd(Z[b[2]], Z[a[2]]);
+
+        const __m128d v1x = _mm_sub_pd(x1, x0), v1y = _mm_sub_pd(y1, y0), v1z = _mm_sub_pd(z1, z0);
+        const __m128d v2x = _mm_sub_pd(x2, x0), v2y = _mm_sub_pd(y2, y0), v2z = _mm_sub_pd(z2, z0);
+        const __m128d v3x = _mm_sub_pd(x2, x1), v3y = _mm_sub_pd(y2, y1), v3z = _mm_sub_pd(z2, z1);
+
+        const __m128d a_sq = _mm_add_pd(_mm_add_pd(_mm_mul_pd(v1x, v1x), _mm_mul_pd(v1y, v1y)), _mm_mul_pd(v1z, v1z));
+        const __m128d b_sq = _mm_add_pd(_mm_add_pd(_mm_mul_pd(v2x, v2x), _mm_mul_pd(v2y, v2y)), _mm_mul_pd(v2z, v2z));
+        const __m128d c_sq = _mm_add_pd(_mm_add_pd(_mm_mul_pd(v3x, v3x), _mm_mul_pd(v3y, v3y)), _mm_mul_pd(v3z, v3z));
+
+        const __m128d nx = _mm_sub_pd(_mm_mul_pd(v1y, v2z), _mm_mul_pd(v1z, v2y));
+        const __m128d ny = _mm_sub_pd(_mm_mul_pd(v1z, v2x), _mm_mul_pd(v1x, v2z));
+        const __m128d nz = _mm_sub_pd(_mm_mul_pd(v1x, v2y), _mm_mul_pd(v1y, v2x));
+        const __m128d area_sq_x4 = _mm_add_pd(_mm_add_pd(_mm_mul_pd(nx, nx), _mm_mul_pd(ny, ny)), _mm_mul_pd(nz, nz));
+
+        const __m128d min_edge = _mm_min_pd(a_sq, _mm_min_pd(b_sq, c_sq));
+        const __m128d max_edge = _mm_max_pd(a_sq, _mm_max_pd(b_sq, c_sq));
+        const __m128d flat = _mm_or_pd(_mm_cmplt_pd(area_sq_x4, _mm_mul_pd(height_epsilon, max_edge)),
+                                       _mm_cmplt_pd(area_sq_x4, min_area));
+        const __m128d sliver = _mm_cmpgt_pd(_mm_mul_pd(max_edge, max_edge), _mm_mul_pd(aspect, area_sq_x4));
+        const int mask = _mm_movemask_pd(_mm_or_pd(_mm_cmpeq_pd(min_edge, zero), _mm_or_pd(flat, sliver)));
+        count += (mask & 1) + (mask >> 1);
+    }
+#endif
+
+    for (; f < end; ++f) {
+        const unsigned int* a = indices + 3 * f;
+        if (DegenerateChecker::isDegenerate(glm::vec3(X[a[0]], Y[a[0]], Z[a[0]]), glm::vec3(X[a[1]], Y[a[1]], Z[a[1]]),
+                                            glm::vec3(X[a[2]], Y[a[2]], Z[a[2]]), bounds)) {
+            count++;
+        }
+    }
+    return count;
+}
+
+// outside[i] = 1 if UV i lies outside [0, 1] in either coordinate.
+void flagUvsOutside(const MeshSoA& mesh, size_t begin, size_t end, unsigned char* outside)
+{
+    const float* U = mesh.u.data();
+    const float* V = mesh.v.data();
+    size_t i = begin;
+#ifdef MESHSOA_SSE2
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    for (; i + 4 <= end; i += 4) {
+        const __m128 u = _mm_loadu_ps(U + i);
+        const __m128 v = _mm_loadu_ps(V + i);
+        const __m128 out = _mm_or_ps(_mm_or_ps(_mm_cmplt_ps(u, zero), _mm_cmpgt_ps(u, one)),
+                                     _mm_or_ps(_mm_cmplt_ps(v, zero), _mm_cmpgt_ps(v, one)));
+        const int mask = _mm_movemask_ps(out);
+        outside[i] = mask & 1;
+        outside[i + 1] = (mask >> 1) & 1;
+        outside[i + 2] = (mask >> 2) & 1;
+        outside[i + 3] = (mask >> 3) & 1;
+    }
+#endif
+    for (; i < end; ++i) {
+        outside[i] = U[i] < 0.0f || U[i] > 1.0f || V[i] < 0.0f || V[i] > 1.0f;
+    }
+}
+
+} // namespace
+
+MeshSoA MeshSoA::fromMesh(const Mesh& mesh)
+{
+    MeshSoA soa;
+    soa.assignPositions(reinterpret_cast<const float*>(mesh.vertices.data()), mesh.vertices.size());
+    soa.assignUvs(reinterpret_cast<const float*>(mesh.uvs.data()), mesh.uvs.size());
+    soa.vertex_indices = mesh.vertex_indices;
+    soa.uv_indices = mesh.uv_indices;
+    return soa;
+}
+
+void MeshSoA::assignPositions(const float* xyz, size_t count)
+{
+    x.resize(count);
+    y.resize(count);
+    z.resize(count);
+    Parallel::forRange(count, SOA_GRAIN, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            x[i] = xyz[3 * i];
+            y[i] = xyz[3 * i + 1];
+            z[i] = xyz[3 * i + 2];
+        }
+    });
+}
+
+void MeshSoA::assignUvs(const float* uv, size_t count)
+{
+    u.resize(count);
+    v.resize(count);
+    Parallel::forRange(count, SOA_GRAIN, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            u[i] = uv[2 * i];
+            v[i] = uv[2 * i + 1];
+        }
+    });
+}
+
+BoundingBox MeshSoA::boundingBox() const
+{
+    BoundingBox box;
+    if (x.empty()) {
+        box.min = glm::vec3(0.0f);
+        box.max = glm::vec3(0.0f);
+        return box;
+    }
+
+    std::mutex mutex;
+    Parallel::forRange(x.size(), SOA_GRAIN, [&](size_t begin, size_t end) {
+        BoundingBox local;
+        minMaxRange(x.data(), begin, end, local.min.x, local.max.x);
+        minMaxRange(y.data(), begin, end, local.min.y, local.max.y);
+        minMaxRange(z.data(), begin, end, local.min.z, local.max.z);
+        std::lock_guard<std::mutex> lock(mutex);
+        for (int axis = 0; axis < 3; ++axis) {
+            box.min[axis] = std::min(box.min[axis], local.min[axis]);
+            box.max[axis] = std::max(box.max[axis], local.max[axis]);
+        }
+    });
+    return box;
+}
+
+int MeshSoA::countDegenerateFaces(const DegenerateThresholds& thresholds) const
+{
+    const DegenerateChecker::Bounds bounds(thresholds);
+    std::atomic<int> count(0);
+    Parallel::forRange(vertex_indices.size() / 3, SOA_GRAIN, [&](size_t begin, size_t end) {
+        count += countDegenerateRange(*this, begin, end, bounds);
+    });
+    return count;
+}
+
+int MeshSoA::countUvsOutOfBounds() const
+{
+    if (u.empty() || uv_indices.empty()) {
+        return 0;
+    }
+
+    // Classify each UV once, then count per face corner like UvChecker
+    std::vector<unsigned char> outside(u.size());
+    Parallel::forRange(u.size(), SOA_GRAIN, [&](size_t begin, size_t end) {
+        flagUvsOutside(*this, begin, end, outside.data());
+    });
+
+    std::atomic<int> count(0);
+    Parallel::forRange(uv_indices.size(), SOA_GRAIN, [&](size_t begin, size_t end) {
+        int local = 0;
+        for (size_t i = begin; i < end; ++i) {
+            local += outside[uv_indices[i]];
+        }
+        count += local;
+    });
+    return count;
+}
@@ -0,0 +1,68 @@
+#ifndef MESHSOA_H
+#define MESHSOA_H
+
+#include "Mesh.h"
+#include "DegenerateChecker.h"
+#include <cstddef>
+#include <new>
+#include <vector>
+
+// Allocator returning storage aligned for full-width SIMD loads.
+template <typename T, size_t Alignment = 64>
+struct AlignedAllocator {
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+    T* allocate(size_t count) {
+        return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(Alignment)));
+    }
+    void deallocate(T* p, size_t) {
+        ::operator delete(p, std::align_val_t(Alignment));
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const { return true; }
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const { return false; }
+};
+
+template <typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+// Structure-of-arrays copy of the mesh data the bulk checks read: one aligned
+// array per coordinate instead of 12-byte glm::vec3 records, so the kernels
+// below can load four values per SIMD register. Indices keep the same meaning
+// as in Mesh.
+struct MeshSoA
+{
+    AlignedVector<float> x, y, z;
+    AlignedVector<float> u, v;
+
+    std::vector<unsigned int> vertex_indices;
+    std::vector<unsigned int> uv_indices;
+
+    size_t vertexCount() const { return x.size(); }
+    size_t uvCount() const { return u.size(); }
+
+    static MeshSoA fromMesh(const Mesh& mesh);
+
+    // Fill from interleaved xyz / uv floats, e.g. the tinyobj attribute arrays.
+    void assignPositions(const float* xyz, size_t count);
+    void assignUvs(const float* uv, size_t count);
+
+    // Same results as Mesh::getBoundingBox, the degenerate face sweep in
+    // DegenerateChecker and UvChecker::countUvsOutOfBounds.
+    BoundingBox boundingBox() const;
+    int countDegenerateFaces(const DegenerateThresholds& thresholds = DegenerateThresholds()) const;
+    int countUvsOutOfBounds() const;
+};
+
+#endif // MESHSOA_H
@@ -1,16 +1,119 @@
 #define TINYOBJLOADER_IMPLEMENTATION
 #include "tiny_obj_loader.h"
+#undef TINYOBJLOADER_IMPLEMENTATION
 #include "ObjLoader.h"
+#include "CompressedFile.h"
+#include "FastObjParser.h"
+#include "MappedFile.h"
+#include "MeshCache.h"
+#include "MeshSoA.h"
+#include "WorkerArena.h"
+#include <atomic>
 #include <iostream>
+#include <memory>
 #include <cstring>
 
+// Cache variants for the two mesh layouts produced from the same file
+const uint32_t CACHE_LAYOUT_INDEXED = 1;
+const uint32_t CACHE_LAYOUT_SHARED = 2;
+
+static std::atomic<ObjLoader::Backend> s_backend(ObjLoader::Backend::MappedParallel);
+
+// The layout, the attributes kept and the parser backend, since the two
+// parsers do not treat malformed input the same way
+static uint32_t cacheVariant(uint32_t layout, const MeshLoadOptions& options)
+{
+    return layout | (options.keep_uvs ? 0x10 : 0) | (options.keep_normals ? 0x20 : 0) |
+           (s_backend == ObjLoader::Backend::TinyObj ? 0x40 : 0);
+}
+
+void ObjLoader::setBackend(Backend backend)
+{
+    s_backend = backend;
+}
+
+ObjLoader::Backend ObjLoader::backend()
+{
+    return s_backend;
+}
+
+// Parser output and scratch of one load. A batch worker keeps them in its
+// arena: they are overwritten in place, so their storage survives.
+struct LoaderBuffers {
+    tinyobj::attrib_t attrib;
+    std::vector<tinyobj::shape_t> shapes;
+    std::vector<ObjChunk> chunks;
+};
+
+static LoaderBuffers& loaderBuffers(WorkerArena* arena, std::unique_ptr<LoaderBuffers>& local)
+{
+    if (!arena) {
+        local.reset(new LoaderBuffers);
+        return *local;
+    }
+    if (!arena->loader_buffers) {
+        arena->loader_buffers = std::make_shared<LoaderBuffers>();
+    }
+    return *static_cast<LoaderBuffers*>(arena->loader_buffers.get());
+}
+
+// With source, also describes the file for the cache before it is parsed.
+// The mapped parser's text is hashed in place; for the streaming backends
+// the file is hashed up front.
+static bool parse(const std::string& path, const MeshLoadOptions& options, tinyobj::attrib_t& attrib, std::vector<tinyobj::shape_t>& shapes,
+                  std::vector<ObjChunk>* chunk_buffers = nullptr, MeshCache::Source* source = nullptr)
+{
+    std::string warn, err;
+    if (source && !MeshCache::describe(path, *source)) {
+        source = nullptr;
+    }
+
+    // tinyobj reads plain text only, so compressed files always stream
+    if (CompressedFile::detect(path) != CompressedFile::Codec::None) {
+        if (source) {
+            MeshCache::hash(path, *source);
+        }
+        if (!FastObjParser::parseCompressed(path, attrib, shapes, err, options.keep_uvs, options.keep_normals)) {
+            std::cerr << "FastObjParser: " << err << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    if (s_backend == ObjLoader::Backend::MappedParallel) {
+        MappedFile file;
+        if (!file.open(path)) {
+            std::cerr << "FastObjParser: cannot open " << path << std::endl;
+            return false;
+        }
+        if (source) {
+            MeshCache::hash(file.data(), file.size(), *source);
+        }
+        if (!FastObjParser::parseText(file.data(), file.size(), attrib, shapes, err, options.keep_uvs, options.keep_normals, chunk_buffers)) {
+            std::cerr << "FastObjParser: " << err << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    if (source) {
+        MeshCache::hash(path, *source);
+    }
+    std::vector<tinyobj::material_t> materials;
+    if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, path.c_str())) {
+        std::cerr << "tinyobjloader: " << warn << err << std::endl;
+        return false;
+    }
+    return true;
+}
+
 bool ObjLoader::load(const std::string& path, Mesh& mesh)
 {
     // This function is deprecated and now calls the indexed loader.
     return load_indexed(path, mesh);
 }
 
-bool ObjLoader::load_indexed(const std::string& path, Mesh& mesh)
+bool ObjLoader::load_indexed(const std::string& path, Mesh& mesh, const MeshLoadOptions& options)
 {
     mesh.vertices.clear();
     mesh.uvs.clear();
@@ -19,16 +122,21 @@ bool ObjLoader::load_indexed(const std::string& path, Mesh& mesh)
     mesh.uv_indices.clear();
     mesh.normal_indices.clear();
 
-    tinyobj::attrib_t attrib;
-    std::vector<tinyobj::shape_t> shapes;
-    std::vector<tinyobj::material_t> materials;
-    std::string warn, err;
+    if (MeshCache::getInstance().load(path, cacheVariant(CACHE_LAYOUT_INDEXED, options), mesh)) {
+        return true;
+    }
 
-    if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, path.c_str())) {
-        std::cerr << "tinyobjloader: " << warn << err << std::endl;
+    std::unique_ptr<LoaderBuffers> local_buffers;
+    LoaderBuffers& buffers = loaderBuffers(options.arena, local_buffers);
+    const tinyobj::attrib_t& attrib = buffers.attrib;
+    const std::vector<tinyobj::shape_t>& shapes = buffers.shapes;
+    MeshCache::Source source;
+    if (!parse(path, options, buffers.attrib, buffers.shapes, &buffers.chunks, MeshCache::getInstance().enabled() ? &source : nullptr)) {
         return false;
     }
 
+    const bool has_normals = options.keep_normals && !attrib.normals.empty();
+
     // Loop over shapes
     for (const auto& shape : shapes) {
         // Loop over faces
@@ -47,26 +155,28 @@ bool ObjLoader::load_indexed(const std::string& path, Mesh& mesh)
                 ));
 
                 // Normal
-                if (idx.normal_index >= 0) {
-                    mesh.normals.push_back(glm::vec3(
-                        attrib.normals[3 * idx.normal_index + 0],
-                        attrib.normals[3 * idx.normal_index + 1],
-                        attrib.normals[3 * idx.normal_index + 2]
-                    ));
-                } else {
-                    // If no normals are present, we'll need to compute them.
-                    // For now, we'll just add a zero vector.
-                    mesh.normals.push_back(glm::vec3(0.0f, 0.0f, 0.0f));
+                if (has_normals) {
+                    if (idx.normal_index >= 0) {
+                        mesh.normals.push_back(glm::vec3(
+                            attrib.normals[3 * idx.normal_index + 0],
+                            attrib.normals[3 * idx.normal_index + 1],
+                            attrib.normals[3 * idx.normal_index + 2]
+                        ));
+                    } else {
+                        mesh.normals.push_back(glm::vec3(0.0f, 0.0f, 0.0f));
+                    }
                 }
 
                 // UV
-                if (idx.texcoord_index >= 0) {
-                    mesh.uvs.push_back(glm::vec2(
-                        attrib.texcoords[2 * idx.texcoord_index + 0],
-                        attrib.texcoords[2 * idx.texcoord_index + 1]
-                    ));
-                } else {
-                    mesh.uvs.push_back(glm::vec2(0.0f, 0.0f));
+                if (options.keep_uvs) {
+                    if (idx.texcoord_index >= 0) {
+                        mesh.uvs.push_back(glm::vec2(
+                            attrib.texcoords[2 * idx.texcoord_index + 0],
+                            attrib.texcoords[2 * idx.texcoord_index + 1]
+                        ));
+                    } else {
+                        mesh.uvs.push_back(glm::vec2(0.0f, 0.0f));
+                    }
                 }
             }
         }
@@ -77,20 +187,135 @@ bool ObjLoader::load_indexed(const std::string& path, Mesh& mesh)
     for(size_t i = 0; i < mesh.vertices.size(); ++i) {
         mesh.vertex_indices[i] = i;
     }
-    mesh.normal_indices = mesh.vertex_indices;
-    mesh.uv_indices = mesh.vertex_indices;
-
-    // If no normals were loaded, compute flat normals
-    if (attrib.normals.empty()) {
-        for (size_t i = 0; i < mesh.vertices.size(); i += 3) {
-            glm::vec3 v1 = mesh.vertices[i + 1] - mesh.vertices[i];
-            glm::vec3 v2 = mesh.vertices[i + 2] - mesh.vertices[i];
-            glm::vec3 normal = glm::normalize(glm::cross(v1, v2));
-            mesh.normals[i] = normal;
-            mesh.normals[i + 1] = normal;
-            mesh.normals[i + 2] = normal;
+    if (options.keep_uvs) {
+        mesh.uv_indices = mesh.vertex_indices;
+    }
+
+    // Files without normals get them on demand (Mesh::ensureNormals)
+    if (!mesh.normals.empty()) {
+        mesh.normal_indices = mesh.vertex_indices;
+    }
+
+    MeshCache::getInstance().store(path, cacheVariant(CACHE_LAYOUT_INDEXED, options), source, mesh);
+    return true;
+}
+
+bool ObjLoader::load_shared(const std::string& path, Mesh& mesh, const MeshLoadOptions& options)
+{
+    mesh.vertices.clear();
+    mesh.uvs.clear();
+    mesh.normals.clear();
+    mesh.vertex_indices.clear();
+    mesh.uv_indices.clear();
+    mesh.normal_indices.clear();
+
+    if (MeshCache::getInstance().load(path, cacheVariant(CACHE_LAYOUT_SHARED, options), mesh)) {
+        return true;
+    }
+
+    std::unique_ptr<LoaderBuffers> local_buffers;
+    LoaderBuffers& buffers = loaderBuffers(options.arena, local_buffers);
+    const tinyobj::attrib_t& attrib = buffers.attrib;
+    const std::vector<tinyobj::shape_t>& shapes = buffers.shapes;
+    MeshCache::Source source;
+    if (!parse(path, options, buffers.attrib, buffers.shapes, &buffers.chunks, MeshCache::getInstance().enabled() ? &source : nullptr)) {
+        return false;
+    }
+
+    // Positions, UVs and normals are kept exactly as they appear in the file.
+    mesh.vertices.resize(attrib.vertices.size() / 3);
+    std::memcpy(mesh.vertices.data(), attrib.vertices.data(), mesh.vertices.size() * sizeof(glm::vec3));
+
+    const bool has_uvs = options.keep_uvs && !attrib.texcoords.empty();
+    const bool has_normals = options.keep_normals && !attrib.normals.empty();
+    if (has_uvs) {
+        mesh.uvs.resize(attrib.texcoords.size() / 2);
+        std::memcpy(mesh.uvs.data(), attrib.texcoords.data(), mesh.uvs.size() * sizeof(glm::vec2));
+    }
+    if (has_normals) {
+        mesh.normals.resize(attrib.normals.size() / 3);
+        std::memcpy(mesh.normals.data(), attrib.normals.data(), mesh.normals.size() * sizeof(glm::vec3));
+    }
+
+    size_t num_corners = 0;
+    for (const auto& shape : shapes) {
+        num_corners += shape.mesh.indices.size();
+    }
+    mesh.vertex_indices.reserve(num_corners);
+    if (has_uvs) mesh.uv_indices.reserve(num_corners);
+    if (has_normals) mesh.normal_indices.reserve(num_corners);
+
+    // Corners without a UV or normal reference share a single zero entry.
+    int missing_uv = -1;
+    int missing_normal = -1;
+
+    for (const auto& shape : shapes) {
+        for (const auto& idx : shape.mesh.indices) {
+            mesh.vertex_indices.push_back(idx.vertex_index);
+
+            if (has_uvs) {
+                if (idx.texcoord_index < 0 && missing_uv < 0) {
+                    missing_uv = mesh.uvs.size();
+                    mesh.uvs.push_back(glm::vec2(0.0f, 0.0f));
+                }
+                mesh.uv_indices.push_back(idx.texcoord_index >= 0 ? idx.texcoord_index : missing_uv);
+            }
+
+            if (has_normals) {
+                if (idx.normal_index < 0 && missing_normal < 0) {
+                    missing_normal = mesh.normals.size();
+                    mesh.normals.push_back(glm::vec3(0.0f, 0.0f, 0.0f));
+                }
+                mesh.normal_indices.push_back(idx.normal_index >= 0 ? idx.normal_index : missing_normal);
+            }
         }
     }
 
+    MeshCache::getInstance().store(path, cacheVariant(CACHE_LAYOUT_SHARED, options), source, mesh);
+    return true;
+}
+
+bool ObjLoader::load_soa(const std::string& path, MeshSoA& mesh, const MeshLoadOptions& options)
+{
+    mesh = MeshSoA();
+
+    MeshLoadOptions parse_options = options;
+    parse_options.keep_normals = false;
+    tinyobj::attrib_t attrib;
+    std::vector<tinyobj::shape_t> shapes;
+    if (!parse(path, parse_options, attrib, shapes)) {
+        return false;
+    }
+
+    mesh.assignPositions(attrib.vertices.data(), attrib.vertices.size() / 3);
+    attrib.vertices = std::vector<tinyobj::real_t>();
+
+    const bool has_uvs = options.keep_uvs && !attrib.texcoords.empty();
+    if (has_uvs) {
+        mesh.assignUvs(attrib.texcoords.data(), attrib.texcoords.size() / 2);
+    }
+
+    size_t num_corners = 0;
+    for (const auto& shape : shapes) {
+        num_corners += shape.mesh.indices.size();
+    }
+    mesh.vertex_indices.reserve(num_corners);
+    if (has_uvs) mesh.uv_indices.reserve(num_corners);
+
+    // Corners without a UV reference share a single zero entry, as in load_shared
+    int missing_uv = -1;
+    for (const auto& shape : shapes) {
+        for (const auto& idx : shape.mesh.indices) {
+            mesh.vertex_indices.push_back(idx.vertex_index);
+            if (has_uvs) {
+                if (idx.texcoord_index < 0 && missing_uv < 0) {
+                    missing_uv = mesh.u.size();
+                    mesh.u.push_back(0.0f);
+                    mesh.v.push_back(0.0f);
+                }
+                mesh.uv_indices.push_back(idx.texcoord_index >= 0 ? idx.texcoord_index : missing_uv);
+            }
+        }
+    }
     return true;
 }
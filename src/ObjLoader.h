@@ -4,11 +4,42 @@
 #include "Mesh.h"
 #include <string>
 
+struct MeshSoA;
+class WorkerArena;
+
+// Which attributes to materialize. Positions and vertex indices are always
+// loaded; dropped attributes leave both the array and its indices empty.
+// Normals missing from the file are not generated here, see Mesh::ensureNormals.
+struct MeshLoadOptions {
+    bool keep_uvs = true;
+    bool keep_normals = true;
+    // Vertices closer than this are merged after loading (see Welder).
+    // Negative disables welding; 0 merges exact duplicates only.
+    float weld_epsilon = -1.0f;
+    // Parser buffers reused across files by a batch worker. Null allocates
+    // them per load.
+    WorkerArena* arena = nullptr;
+};
+
 class ObjLoader
 {
 public:
+    enum class Backend {
+        TinyObj,        // tinyobj::LoadObj, single-threaded stream parsing
+        MappedParallel  // FastObjParser, memory-mapped and chunk-parallel
+    };
+
+    static void setBackend(Backend backend);
+    static Backend backend();
+
     static bool load(const std::string& path, Mesh& mesh);
-    static bool load_indexed(const std::string& path, Mesh& mesh);
+    static bool load_indexed(const std::string& path, Mesh& mesh, const MeshLoadOptions& options = MeshLoadOptions());
+    // Keeps the OBJ position/UV/normal indices as shared indices instead of
+    // expanding every face corner into its own vertex.
+    static bool load_shared(const std::string& path, Mesh& mesh, const MeshLoadOptions& options = MeshLoadOptions());
+    // Shared indices straight into structure-of-arrays storage, without an
+    // intermediate Mesh. Normals are never loaded and the cache is not used.
+    static bool load_soa(const std::string& path, MeshSoA& mesh, const MeshLoadOptions& options = MeshLoadOptions());
 };
 
 #endif // OBJLOADER_H
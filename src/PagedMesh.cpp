@@ -0,0 +1,152 @@
+#include "PagedMesh.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace {
+
+const char STORE_MAGIC[8] = {'M', 'S', 'H', 'P', 'A', 'G', 'E', 'D'};
+const uint32_t STORE_VERSION = 1;
+const uint64_t PAGE_ALIGNMENT = 64 << 10;
+
+struct StoreHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t page_elements;
+    uint64_t counts[PagedMesh::NumSections];
+    uint64_t offsets[PagedMesh::NumSections];
+};
+
+const size_t ELEMENT_SIZES[PagedMesh::NumSections] = {
+    sizeof(glm::vec3), sizeof(glm::vec2), sizeof(PagedFace), sizeof(PagedFace)
+};
+
+uint64_t alignUp(uint64_t value)
+{
+    return (value + PAGE_ALIGNMENT - 1) / PAGE_ALIGNMENT * PAGE_ALIGNMENT;
+}
+
+bool writePadding(std::ofstream& out, uint64_t to)
+{
+    static const char zeros[4096] = {};
+    uint64_t position = static_cast<uint64_t>(out.tellp());
+    while (position < to) {
+        const size_t chunk = static_cast<size_t>(std::min<uint64_t>(sizeof(zeros), to - position));
+        out.write(zeros, chunk);
+        position += chunk;
+    }
+    return static_cast<bool>(out);
+}
+
+} // namespace
+
+bool PagedMesh::write(const std::string& path, const Mesh& mesh)
+{
+    const bool has_uv_faces = !mesh.uvs.empty() && mesh.uv_indices.size() == mesh.vertex_indices.size();
+    const void* data[NumSections] = {
+        mesh.vertices.data(), mesh.uvs.data(), mesh.vertex_indices.data(), mesh.uv_indices.data()
+    };
+
+    StoreHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, STORE_MAGIC, sizeof(STORE_MAGIC));
+    header.version = STORE_VERSION;
+    header.page_elements = static_cast<uint32_t>(PAGE_ELEMENTS);
+    header.counts[Positions] = mesh.vertices.size();
+    header.counts[Uvs] = has_uv_faces ? mesh.uvs.size() : 0;
+    header.counts[Faces] = mesh.vertex_indices.size() / 3;
+    header.counts[UvFaces] = has_uv_faces ? mesh.vertex_indices.size() / 3 : 0;
+
+    uint64_t offset = alignUp(sizeof(header));
+    for (int s = 0; s < NumSections; ++s) {
+        header.offsets[s] = offset;
+        offset = alignUp(offset + header.counts[s] * ELEMENT_SIZES[s]);
+    }
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        return false;
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (int s = 0; s < NumSections; ++s) {
+        if (!writePadding(out, header.offsets[s])) {
+            return false;
+        }
+        out.write(static_cast<const char*>(data[s]), static_cast<std::streamsize>(header.counts[s] * ELEMENT_SIZES[s]));
+    }
+    return static_cast<bool>(out);
+}
+
+bool PagedMesh::open(const std::string& store_path, size_t max_resident_pages)
+{
+    close();
+
+    std::ifstream in(store_path, std::ios::binary);
+    StoreHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, STORE_MAGIC, sizeof(STORE_MAGIC)) != 0 ||
+        header.version != STORE_VERSION || header.page_elements != PAGE_ELEMENTS) {
+        return false;
+    }
+    for (int s = 0; s < NumSections; ++s) {
+        if (header.offsets[s] % PAGE_ALIGNMENT != 0) {
+            return false;
+        }
+        counts[s] = header.counts[s];
+        offsets[s] = header.offsets[s];
+    }
+    path = store_path;
+    max_pages = std::max<size_t>(1, max_resident_pages);
+    return true;
+}
+
+void PagedMesh::close()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    cache.clear();
+    lru.clear();
+    counts.fill(0);
+    offsets.fill(0);
+    path.clear();
+}
+
+PagedMesh::PagePtr PagedMesh::page(Section section, size_t index)
+{
+    if (index >= counts[section]) {
+        return nullptr;
+    }
+    const uint64_t number = index / PAGE_ELEMENTS;
+    const PageKey key = (static_cast<uint64_t>(section) << 56) | number;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = cache.find(key);
+    if (found != cache.end()) {
+        lru.splice(lru.begin(), lru, found->second.position);
+        return found->second.page;
+    }
+
+    auto page = std::make_shared<Page>();
+    page->first = static_cast<size_t>(number * PAGE_ELEMENTS);
+    page->count = static_cast<size_t>(std::min<uint64_t>(PAGE_ELEMENTS, counts[section] - page->first));
+    const size_t bytes = page->count * ELEMENT_SIZES[section];
+    if (!page->file.openRange(path, offsets[section] + number * PAGE_ELEMENTS * ELEMENT_SIZES[section], bytes) ||
+        page->file.size() < bytes) {
+        return nullptr;
+    }
+
+    // Evicted pages stay mapped while a cursor still holds them
+    while (cache.size() >= max_pages) {
+        cache.erase(lru.back());
+        lru.pop_back();
+    }
+    lru.push_front(key);
+    cache[key] = {page, lru.begin()};
+    return page;
+}
+
+size_t PagedMesh::residentPages() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return cache.size();
+}
@@ -0,0 +1,115 @@
+#ifndef PAGEDMESH_H
+#define PAGEDMESH_H
+
+#include "Mesh.h"
+#include "MappedFile.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// Out-of-core mesh store for scans too large to check in memory. The mesh
+// arrays are written once to a store file in fixed-size pages; PagedMesh then
+// maps pages on demand and keeps at most a fixed number of them resident,
+// unmapping the least recently used ones. Checks stream through the pages
+// with PageCursor (see PagedMeshChecker), so their working set is bounded by
+// the page budget rather than by the mesh size.
+//
+// Faces are stored as triples so that a face never straddles two pages.
+class PagedMesh
+{
+public:
+    enum Section {
+        Positions, // glm::vec3 per vertex
+        Uvs,       // glm::vec2 per UV
+        Faces,     // 3 vertex indices per face
+        UvFaces,   // 3 UV indices per face, empty without UVs
+        NumSections
+    };
+
+    // Elements per page in every section. A page is 1-3 MiB and pages start
+    // on 64 KiB boundaries, so each one can be mapped on its own.
+    static constexpr size_t PAGE_ELEMENTS = size_t(1) << 18;
+
+    // A mapped page. Holding one keeps it mapped even after eviction.
+    struct Page {
+        MappedFile file;
+        size_t first; // Index of the first element
+        size_t count;
+    };
+    using PagePtr = std::shared_ptr<const Page>;
+
+    // Writes the arrays of mesh to a store file. Faces with a missing UV face
+    // drop the UV section. Returns false if the file cannot be written.
+    static bool write(const std::string& path, const Mesh& mesh);
+
+    // max_resident_pages bounds the pages kept mapped by the cache.
+    bool open(const std::string& path, size_t max_resident_pages = 256);
+    void close();
+
+    size_t count(Section section) const { return counts[section]; }
+    size_t vertexCount() const { return counts[Positions]; }
+    size_t faceCount() const { return counts[Faces]; }
+    size_t pageCount(Section section) const { return (counts[section] + PAGE_ELEMENTS - 1) / PAGE_ELEMENTS; }
+
+    // Maps the page holding element 'index' of the section, or returns the
+    // cached mapping. Null if the page cannot be mapped. Thread-safe.
+    PagePtr page(Section section, size_t index);
+
+    // Pages currently held by the cache.
+    size_t residentPages() const;
+
+private:
+    std::string path;
+    std::array<uint64_t, NumSections> counts = {};
+    std::array<uint64_t, NumSections> offsets = {};
+    size_t max_pages = 0;
+
+    using PageKey = uint64_t; // section << 56 | page number
+    mutable std::mutex mutex;
+    std::list<PageKey> lru; // Most recently used first
+    struct CacheEntry {
+        PagePtr page;
+        std::list<PageKey>::iterator position;
+    };
+    std::unordered_map<PageKey, CacheEntry> cache;
+};
+
+// Random access to one section through the page cache. Remembers the last
+// page it used, so runs of nearby indices cost one cache lookup per page.
+template <typename T, PagedMesh::Section S>
+class PageCursor
+{
+public:
+    explicit PageCursor(PagedMesh& mesh) : mesh(mesh) {}
+
+    // Null if the page cannot be mapped.
+    const T* get(size_t index) {
+        if (!current || index < current->first || index >= current->first + current->count) {
+            current = mesh.page(S, index);
+            if (!current) {
+                return nullptr;
+            }
+        }
+        return reinterpret_cast<const T*>(current->file.data()) + (index - current->first);
+    }
+
+private:
+    PagedMesh& mesh;
+    PagedMesh::PagePtr current;
+};
+
+struct PagedFace {
+    unsigned int v[3];
+};
+
+using PositionCursor = PageCursor<glm::vec3, PagedMesh::Positions>;
+using UvCursor = PageCursor<glm::vec2, PagedMesh::Uvs>;
+using FaceCursor = PageCursor<PagedFace, PagedMesh::Faces>;
+using UvFaceCursor = PageCursor<PagedFace, PagedMesh::UvFaces>;
+
+#endif // PAGEDMESH_H
@@ -0,0 +1,236 @@
+#include "PagedMeshChecker.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+namespace {
+
+// Edge keys buffered per partition before they are appended to its file
+const size_t SPILL_BUFFER_KEYS = 1 << 16;
+
+// Keeps the number of open scratch files well below descriptor limits
+const size_t MAX_PARTITIONS = 256;
+
+uint64_t edgeKey(unsigned int a, unsigned int b)
+{
+    return a < b ? (static_cast<uint64_t>(a) << 32) | b : (static_cast<uint64_t>(b) << 32) | a;
+}
+
+uint64_t mix(uint64_t x)
+{
+    // splitmix64 finalizer
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ull;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBull;
+    x ^= x >> 31;
+    return x;
+}
+
+// Adds the runs of equal keys in sorted order to the counters.
+void countRuns(std::vector<uint64_t>& keys, size_t& boundary_edges, size_t& non_manifold_edges)
+{
+    std::sort(keys.begin(), keys.end());
+    for (size_t i = 0; i < keys.size();) {
+        size_t j = i + 1;
+        while (j < keys.size() && keys[j] == keys[i]) {
+            ++j;
+        }
+        if (j - i == 1) {
+            ++boundary_edges;
+        } else if (j - i > 2) {
+            ++non_manifold_edges;
+        }
+        i = j;
+    }
+}
+
+// Calls body(first_face, faces, count) for each page of faces, one page per
+// task. False if a page could not be mapped or body returned false.
+template <typename Body>
+bool forEachFacePage(PagedMesh& mesh, const Body& body)
+{
+    std::atomic<bool> ok(true);
+    Parallel::forRange(mesh.pageCount(PagedMesh::Faces), 1, [&](size_t begin, size_t end) {
+        for (size_t p = begin; p < end && ok; ++p) {
+            PagedMesh::PagePtr page = mesh.page(PagedMesh::Faces, p * PagedMesh::PAGE_ELEMENTS);
+            if (!page || !body(page->first, reinterpret_cast<const PagedFace*>(page->file.data()), page->count)) {
+                ok = false;
+            }
+        }
+    });
+    return ok;
+}
+
+} // namespace
+
+PagedMeshChecker::Result PagedMeshChecker::check(PagedMesh& mesh, const std::string& scratch_prefix, size_t memory_budget,
+                                                 const DegenerateThresholds& thresholds)
+{
+    Result result;
+    result.degenerates_counted = countDegenerateFaces(mesh, thresholds, result.degenerate_faces_count);
+    result.has_uvs = mesh.count(PagedMesh::UvFaces) > 0;
+    result.uvs_counted = !result.has_uvs || countUvsOutOfBounds(mesh, result.uvs_out_of_bounds_count);
+    result.edges_counted = countEdges(mesh, scratch_prefix, memory_budget, result.boundary_edges_count, result.non_manifold_edges_count);
+    result.is_watertight = result.edges_counted && result.boundary_edges_count == 0;
+    return result;
+}
+
+bool PagedMeshChecker::countDegenerateFaces(PagedMesh& mesh, const DegenerateThresholds& thresholds, size_t& degenerate_faces)
+{
+    const DegenerateChecker::Bounds bounds(thresholds);
+    const size_t num_vertices = mesh.vertexCount();
+    std::atomic<size_t> count(0);
+    const bool ok = forEachFacePage(mesh, [&](size_t, const PagedFace* faces, size_t num_faces) {
+        PositionCursor positions(mesh);
+        size_t local = 0;
+        for (size_t f = 0; f < num_faces; ++f) {
+            const unsigned int* v = faces[f].v;
+            if (v[0] >= num_vertices || v[1] >= num_vertices || v[2] >= num_vertices) {
+                continue;
+            }
+            // Copies, as the next lookup may move the cursor to another page
+            glm::vec3 p[3];
+            for (int k = 0; k < 3; ++k) {
+                const glm::vec3* position = positions.get(v[k]);
+                if (!position) {
+                    return false;
+                }
+                p[k] = *position;
+            }
+            if (DegenerateChecker::isDegenerate(p[0], p[1], p[2], bounds)) {
+                ++local;
+            }
+        }
+        count += local;
+        return true;
+    });
+    degenerate_faces = count;
+    return ok;
+}
+
+bool PagedMeshChecker::countUvsOutOfBounds(PagedMesh& mesh, size_t& uvs_out_of_bounds)
+{
+    const size_t num_uvs = mesh.count(PagedMesh::Uvs);
+    std::atomic<size_t> count(0);
+    std::atomic<bool> ok(true);
+    Parallel::forRange(mesh.pageCount(PagedMesh::UvFaces), 1, [&](size_t begin, size_t end) {
+        UvCursor uvs(mesh);
+        size_t local = 0;
+        for (size_t p = begin; p < end && ok; ++p) {
+            PagedMesh::PagePtr page = mesh.page(PagedMesh::UvFaces, p * PagedMesh::PAGE_ELEMENTS);
+            if (!page) {
+                ok = false;
+                break;
+            }
+            const PagedFace* faces = reinterpret_cast<const PagedFace*>(page->file.data());
+            for (size_t f = 0; f < page->count && ok; ++f) {
+                for (unsigned int index : faces[f].v) {
+                    if (index >= num_uvs) {
+                        continue;
+                    }
+                    const glm::vec2* uv = uvs.get(index);
+                    if (!uv) {
+                        ok = false;
+                        break;
+                    }
+                    if (uv->x < 0.0f || uv->x > 1.0f || uv->y < 0.0f || uv->y > 1.0f) {
+                        ++local;
+                    }
+                }
+            }
+        }
+        count += local;
+    });
+    uvs_out_of_bounds = count;
+    return ok;
+}
+
+bool PagedMeshChecker::countEdges(PagedMesh& mesh, const std::string& scratch_prefix, size_t memory_budget,
+                                  size_t& boundary_edges, size_t& non_manifold_edges)
+{
+    boundary_edges = 0;
+    non_manifold_edges = 0;
+    const uint64_t total_bytes = static_cast<uint64_t>(mesh.faceCount()) * 3 * sizeof(uint64_t);
+    const size_t budget = std::max<size_t>(memory_budget, 1 << 20);
+    const size_t num_partitions = static_cast<size_t>(std::min<uint64_t>(MAX_PARTITIONS, (total_bytes + budget - 1) / budget));
+
+    // Collapsed edges of degenerate faces are not edges
+    auto forEachEdge = [&](const auto& emit) {
+        FaceCursor faces(mesh);
+        for (size_t f = 0; f < mesh.faceCount(); ++f) {
+            const PagedFace* face = faces.get(f);
+            if (!face) {
+                return false;
+            }
+            for (int k = 0; k < 3; ++k) {
+                const unsigned int a = face->v[k];
+                const unsigned int b = face->v[(k + 1) % 3];
+                if (a != b) {
+                    emit(edgeKey(a, b));
+                }
+            }
+        }
+        return true;
+    };
+
+    if (num_partitions <= 1) {
+        std::vector<uint64_t> keys;
+        keys.reserve(mesh.faceCount() * 3);
+        if (!forEachEdge([&](uint64_t key) { keys.push_back(key); })) {
+            return false;
+        }
+        countRuns(keys, boundary_edges, non_manifold_edges);
+        return true;
+    }
+
+    std::vector<std::string> paths(num_partitions);
+    std::vector<std::unique_ptr<std::ofstream>> files(num_partitions);
+    std::vector<std::vector<uint64_t>> buffers(num_partitions);
+    bool ok = true;
+    for (size_t i = 0; i < num_partitions && ok; ++i) {
+        paths[i] = scratch_prefix + "." + std::to_string(i);
+        files[i].reset(new std::ofstream(paths[i], std::ios::binary | std::ios::trunc));
+        ok = static_cast<bool>(*files[i]);
+        buffers[i].reserve(SPILL_BUFFER_KEYS);
+    }
+    auto flush = [&](size_t i) {
+        files[i]->write(reinterpret_cast<const char*>(buffers[i].data()), buffers[i].size() * sizeof(uint64_t));
+        buffers[i].clear();
+    };
+    if (ok) {
+        ok = forEachEdge([&](uint64_t key) {
+            const size_t i = mix(key) % num_partitions;
+            buffers[i].push_back(key);
+            if (buffers[i].size() == SPILL_BUFFER_KEYS) {
+                flush(i);
+            }
+        });
+    }
+    for (size_t i = 0; i < num_partitions && files[i]; ++i) {
+        flush(i);
+        ok = ok && static_cast<bool>(*files[i]);
+        files[i].reset();
+    }
+
+    std::vector<uint64_t> keys;
+    for (size_t i = 0; i < num_partitions && ok; ++i) {
+        std::ifstream in(paths[i], std::ios::binary | std::ios::ate);
+        const std::streamoff bytes = in.tellg();
+        keys.resize(bytes > 0 ? static_cast<size_t>(bytes) / sizeof(uint64_t) : 0);
+        in.seekg(0);
+        ok = static_cast<bool>(in.read(reinterpret_cast<char*>(keys.data()), keys.size() * sizeof(uint64_t)));
+        countRuns(keys, boundary_edges, non_manifold_edges);
+    }
+    for (const std::string& path : paths) {
+        if (!path.empty()) {
+            std::remove(path.c_str());
+        }
+    }
+    return ok;
+}
@@ -0,0 +1,48 @@
+#ifndef PAGEDMESHCHECKER_H
+#define PAGEDMESHCHECKER_H
+
+#include "PagedMesh.h"
+#include "DegenerateChecker.h"
+#include <cstddef>
+#include <string>
+
+// Checks that only need local access, streamed through a PagedMesh so that
+// memory use stays bounded for meshes that do not fit in RAM. Results match
+// the in-memory checks on the raw indices; there is no CGAL soup repair.
+class PagedMeshChecker
+{
+public:
+    struct Result {
+        bool is_watertight = false;
+        size_t boundary_edges_count = 0;
+        size_t non_manifold_edges_count = 0;
+        size_t degenerate_faces_count = 0;
+        bool has_uvs = false;
+        size_t uvs_out_of_bounds_count = 0;
+        bool edges_counted = false; // False if the scratch files failed
+        bool degenerates_counted = false; // False if a page could not be mapped
+        bool uvs_counted = false; // Likewise
+    };
+
+    // Runs all of the checks below. Scratch files are created as
+    // scratch_prefix + ".<n>" and removed afterwards, so concurrent checks
+    // need distinct prefixes.
+    static Result check(PagedMesh& mesh, const std::string& scratch_prefix, size_t memory_budget,
+                        const DegenerateThresholds& thresholds = DegenerateThresholds());
+
+    // DegenerateChecker's test, face by face. False if a face or position
+    // page could not be mapped.
+    static bool countDegenerateFaces(PagedMesh& mesh, const DegenerateThresholds& thresholds, size_t& degenerate_faces);
+    // Per face corner, like UvChecker::countUvsOutOfBounds. False if a UV
+    // face or UV page could not be mapped.
+    static bool countUvsOutOfBounds(PagedMesh& mesh, size_t& uvs_out_of_bounds);
+
+    // Counts edges used by exactly one face (boundary) and by more than two
+    // faces (non-manifold). The edge list is split by hash into partitions
+    // that each fit in memory_budget bytes; with more than one partition they
+    // are spilled to scratch files and sorted one at a time.
+    static bool countEdges(PagedMesh& mesh, const std::string& scratch_prefix, size_t memory_budget,
+                           size_t& boundary_edges, size_t& non_manifold_edges);
+};
+
+#endif // PAGEDMESHCHECKER_H
@@ -0,0 +1,140 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include "TaskScheduler.h"
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace Parallel {
+
+inline unsigned int threadCount()
+{
+    return TaskScheduler::getInstance().threadCount();
+}
+
+// Splits [0, count) into contiguous ranges and calls body(begin, end) for each
+// range as a scheduler task; the first range runs on the calling thread.
+// Ranges smaller than min_grain are not split further.
+template <typename Body>
+void forRange(size_t count, size_t min_grain, const Body& body)
+{
+    if (count == 0) {
+        return;
+    }
+    size_t max_tasks = std::max<size_t>(1, count / std::max<size_t>(1, min_grain));
+    size_t num_tasks = std::min<size_t>(threadCount(), max_tasks);
+    if (num_tasks <= 1) {
+        body(size_t(0), count);
+        return;
+    }
+
+    size_t step = (count + num_tasks - 1) / num_tasks;
+    TaskGroup group;
+    for (size_t begin = step; begin < count; begin += step) {
+        size_t end = std::min(count, begin + step);
+        group.run([&body, begin, end]() { body(begin, end); });
+    }
+    body(size_t(0), std::min(count, step));
+    group.wait();
+}
+
+// Sorts [first, last) by sorting one slice per thread and then merging
+// neighbouring slices pairwise, also in parallel.
+template <typename Iterator, typename Compare>
+void sort(Iterator first, Iterator last, Compare compare)
+{
+    const size_t count = static_cast<size_t>(last - first);
+    const size_t min_slice = 1 << 15;
+    size_t num_slices = std::min<size_t>(threadCount(), std::max<size_t>(1, count / min_slice));
+    if (num_slices <= 1) {
+        std::sort(first, last, compare);
+        return;
+    }
+
+    std::vector<size_t> bounds(num_slices + 1);
+    for (size_t i = 0; i <= num_slices; ++i) {
+        bounds[i] = count * i / num_slices;
+    }
+    forRange(num_slices, 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            std::sort(first + bounds[i], first + bounds[i + 1], compare);
+        }
+    });
+
+    for (size_t width = 1; width < num_slices; width *= 2) {
+        const size_t num_merges = (num_slices + 2 * width - 1) / (2 * width);
+        forRange(num_merges, 1, [&](size_t begin, size_t end) {
+            for (size_t m = begin; m < end; ++m) {
+                const size_t left = m * 2 * width;
+                const size_t middle = std::min(left + width, num_slices);
+                const size_t right = std::min(left + 2 * width, num_slices);
+                if (middle < right) {
+                    std::inplace_merge(first + bounds[left], first + bounds[middle], first + bounds[right], compare);
+                }
+            }
+        });
+    }
+}
+
+// Stable LSD radix sort of items by key(item), an unsigned integer below
+// 2^key_bits, eight bits per pass. Each pass counts the digits of one slice
+// per thread, then every slice scatters to its own offsets in parallel.
+// Passes on a digit all keys share are skipped. scratch is the second
+// buffer and holds the old contents afterwards.
+template <typename T, typename Key>
+void radixSort(std::vector<T>& items, std::vector<T>& scratch, unsigned int key_bits, const Key& key)
+{
+    const size_t count = items.size();
+    const size_t radix = 256;
+    const size_t min_slice = 1 << 15;
+    const size_t num_slices = std::min<size_t>(threadCount(), std::max<size_t>(1, count / min_slice));
+    std::vector<size_t> bounds(num_slices + 1);
+    for (size_t i = 0; i <= num_slices; ++i) {
+        bounds[i] = count * i / num_slices;
+    }
+    scratch.resize(count);
+
+    // offsets[slice * radix + digit]: digit count, then scatter position
+    std::vector<size_t> offsets(num_slices * radix);
+    for (unsigned int shift = 0; shift < key_bits; shift += 8) {
+        std::fill(offsets.begin(), offsets.end(), 0);
+        forRange(num_slices, 1, [&](size_t begin, size_t end) {
+            for (size_t s = begin; s < end; ++s) {
+                size_t* histogram = &offsets[s * radix];
+                for (size_t i = bounds[s]; i < bounds[s + 1]; ++i) {
+                    ++histogram[(key(items[i]) >> shift) & (radix - 1)];
+                }
+            }
+        });
+
+        size_t total = 0;
+        bool trivial = false;
+        for (size_t digit = 0; digit < radix; ++digit) {
+            const size_t digit_start = total;
+            for (size_t s = 0; s < num_slices; ++s) {
+                const size_t n = offsets[s * radix + digit];
+                offsets[s * radix + digit] = total;
+                total += n;
+            }
+            trivial = trivial || total - digit_start == count;
+        }
+        if (trivial) {
+            continue;
+        }
+
+        forRange(num_slices, 1, [&](size_t begin, size_t end) {
+            for (size_t s = begin; s < end; ++s) {
+                size_t* position = &offsets[s * radix];
+                for (size_t i = bounds[s]; i < bounds[s + 1]; ++i) {
+                    scratch[position[(key(items[i]) >> shift) & (radix - 1)]++] = items[i];
+                }
+            }
+        });
+        items.swap(scratch);
+    }
+}
+
+} // namespace Parallel
+
+#endif // PARALLEL_H
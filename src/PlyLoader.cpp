@@ -0,0 +1,391 @@
+#include "PlyLoader.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <initializer_list>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+enum class PlyType { Int8, Uint8, Int16, Uint16, Int32, Uint32, Float32, Float64, Invalid };
+
+struct PlyProperty {
+    std::string name;
+    PlyType type = PlyType::Invalid;
+    bool is_list = false;
+    PlyType count_type = PlyType::Invalid;
+};
+
+struct PlyElement {
+    std::string name;
+    size_t count = 0;
+    std::vector<PlyProperty> properties;
+};
+
+PlyType parseType(const std::string& name)
+{
+    if (name == "char" || name == "int8") return PlyType::Int8;
+    if (name == "uchar" || name == "uint8") return PlyType::Uint8;
+    if (name == "short" || name == "int16") return PlyType::Int16;
+    if (name == "ushort" || name == "uint16") return PlyType::Uint16;
+    if (name == "int" || name == "int32") return PlyType::Int32;
+    if (name == "uint" || name == "uint32") return PlyType::Uint32;
+    if (name == "float" || name == "float32") return PlyType::Float32;
+    if (name == "double" || name == "float64") return PlyType::Float64;
+    return PlyType::Invalid;
+}
+
+size_t typeSize(PlyType type)
+{
+    switch (type) {
+    case PlyType::Int8: case PlyType::Uint8: return 1;
+    case PlyType::Int16: case PlyType::Uint16: return 2;
+    case PlyType::Int32: case PlyType::Uint32: case PlyType::Float32: return 4;
+    case PlyType::Float64: return 8;
+    default: return 0;
+    }
+}
+
+bool hostIsLittleEndian()
+{
+    const uint16_t probe = 1;
+    unsigned char first;
+    std::memcpy(&first, &probe, 1);
+    return first == 1;
+}
+
+// Reads one scalar, swapping bytes when the file and host byte order differ.
+double readValue(const char* p, PlyType type, bool swap)
+{
+    unsigned char bytes[8];
+    size_t size = typeSize(type);
+    std::memcpy(bytes, p, size);
+    if (swap) {
+        for (size_t i = 0; i < size / 2; ++i) {
+            std::swap(bytes[i], bytes[size - 1 - i]);
+        }
+    }
+    switch (type) {
+    case PlyType::Int8: { int8_t v; std::memcpy(&v, bytes, 1); return v; }
+    case PlyType::Uint8: { uint8_t v; std::memcpy(&v, bytes, 1); return v; }
+    case PlyType::Int16: { int16_t v; std::memcpy(&v, bytes, 2); return v; }
+    case PlyType::Uint16: { uint16_t v; std::memcpy(&v, bytes, 2); return v; }
+    case PlyType::Int32: { int32_t v; std::memcpy(&v, bytes, 4); return v; }
+    case PlyType::Uint32: { uint32_t v; std::memcpy(&v, bytes, 4); return v; }
+    case PlyType::Float32: { float v; std::memcpy(&v, bytes, 4); return v; }
+    case PlyType::Float64: { double v; std::memcpy(&v, bytes, 8); return v; }
+    default: return 0.0;
+    }
+}
+
+// Size of one element record, or 0 if it contains list properties.
+size_t fixedStride(const PlyElement& element)
+{
+    size_t stride = 0;
+    for (const auto& property : element.properties) {
+        if (property.is_list) {
+            return 0;
+        }
+        stride += typeSize(property.type);
+    }
+    return stride;
+}
+
+// Advances past one property of one record; returns nullptr on overrun.
+const char* skipProperty(const char* p, const char* end, const PlyProperty& property, bool swap)
+{
+    if (property.is_list) {
+        if (p + typeSize(property.count_type) > end) return nullptr;
+        size_t count = static_cast<size_t>(readValue(p, property.count_type, swap));
+        p += typeSize(property.count_type) + count * typeSize(property.type);
+    } else {
+        p += typeSize(property.type);
+    }
+    return p <= end ? p : nullptr;
+}
+
+int findProperty(const PlyElement& element, std::initializer_list<const char*> names)
+{
+    for (const char* name : names) {
+        for (size_t i = 0; i < element.properties.size(); ++i) {
+            if (element.properties[i].name == name && !element.properties[i].is_list) {
+                return static_cast<int>(i);
+            }
+        }
+    }
+    return -1;
+}
+
+} // namespace
+
+bool PlyLoader::load(const std::string& path, Mesh& mesh, const MeshLoadOptions& options)
+{
+    mesh.vertices.clear();
+    mesh.uvs.clear();
+    mesh.normals.clear();
+    mesh.vertex_indices.clear();
+    mesh.uv_indices.clear();
+    mesh.normal_indices.clear();
+
+    MappedFile file;
+    if (!file.open(path)) {
+        std::cerr << "PlyLoader: cannot open " << path << std::endl;
+        return false;
+    }
+    const char* data = file.data();
+    const char* end = data + file.size();
+
+    // --- Header ---
+    const char* end_marker = "end_header";
+    const char* header_end = nullptr;
+    for (const char* p = data; p + 10 <= end; ++p) {
+        if (*p == 'e' && std::memcmp(p, end_marker, 10) == 0) {
+            header_end = p + 10;
+            break;
+        }
+    }
+    if (file.size() < 4 || std::memcmp(data, "ply", 3) != 0 || !header_end) {
+        std::cerr << "PlyLoader: " << path << " is not a PLY file" << std::endl;
+        return false;
+    }
+    while (header_end < end && *header_end != '\n') {
+        ++header_end;
+    }
+    if (header_end < end) {
+        ++header_end;
+    }
+
+    std::istringstream header(std::string(data, header_end - data));
+    std::string line;
+    std::string format;
+    std::vector<PlyElement> elements;
+    while (std::getline(header, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        std::istringstream tokens(line);
+        std::string keyword;
+        tokens >> keyword;
+        if (keyword == "format") {
+            tokens >> format;
+        } else if (keyword == "element") {
+            PlyElement element;
+            tokens >> element.name >> element.count;
+            elements.push_back(element);
+        } else if (keyword == "property" && !elements.empty()) {
+            PlyProperty property;
+            std::string type;
+            tokens >> type;
+            if (type == "list") {
+                std::string count_type, item_type;
+                tokens >> count_type >> item_type;
+                property.is_list = true;
+                property.count_type = parseType(count_type);
+                property.type = parseType(item_type);
+                if (property.count_type == PlyType::Invalid) {
+                    std::cerr << "PlyLoader: unsupported list count type " << count_type << std::endl;
+                    return false;
+                }
+            } else {
+                property.type = parseType(type);
+            }
+            if (property.type == PlyType::Invalid) {
+                std::cerr << "PlyLoader: unsupported property type in " << path << std::endl;
+                return false;
+            }
+            tokens >> property.name;
+            elements.back().properties.push_back(property);
+        }
+    }
+
+    bool file_little_endian;
+    if (format == "binary_little_endian") {
+        file_little_endian = true;
+    } else if (format == "binary_big_endian") {
+        file_little_endian = false;
+    } else {
+        std::cerr << "PlyLoader: only binary PLY is supported (" << path << " is " << format << ")" << std::endl;
+        return false;
+    }
+    const bool swap = file_little_endian != hostIsLittleEndian();
+
+    // --- Body ---
+    const char* p = header_end;
+    for (const auto& element : elements) {
+        const size_t stride = fixedStride(element);
+
+        if (element.name == "vertex") {
+            int x = findProperty(element, {"x"});
+            int y = findProperty(element, {"y"});
+            int z = findProperty(element, {"z"});
+            if (x < 0 || y < 0 || z < 0 || stride == 0) {
+                std::cerr << "PlyLoader: vertex element needs fixed-size x, y and z properties" << std::endl;
+                return false;
+            }
+            if (element.count > static_cast<size_t>(end - p) / stride) {
+                std::cerr << "PlyLoader: truncated vertex data in " << path << std::endl;
+                return false;
+            }
+
+            int nx = options.keep_normals ? findProperty(element, {"nx"}) : -1;
+            int ny = options.keep_normals ? findProperty(element, {"ny"}) : -1;
+            int nz = options.keep_normals ? findProperty(element, {"nz"}) : -1;
+            int u = options.keep_uvs ? findProperty(element, {"u", "s", "texture_u", "texture_s"}) : -1;
+            int v = options.keep_uvs ? findProperty(element, {"v", "t", "texture_v", "texture_t"}) : -1;
+
+            std::vector<size_t> offsets(element.properties.size());
+            size_t offset = 0;
+            for (size_t i = 0; i < element.properties.size(); ++i) {
+                offsets[i] = offset;
+                offset += typeSize(element.properties[i].type);
+            }
+
+            mesh.vertices.resize(element.count);
+            const auto& props = element.properties;
+            const bool float_positions = props[x].type == PlyType::Float32 && props[y].type == PlyType::Float32 && props[z].type == PlyType::Float32 &&
+                                         offsets[y] == offsets[x] + 4 && offsets[z] == offsets[x] + 8;
+            if (!swap && float_positions && stride == sizeof(glm::vec3)) {
+                // Positions only: the whole element is one bulk copy
+                std::memcpy(mesh.vertices.data(), p, element.count * sizeof(glm::vec3));
+            } else if (!swap && float_positions) {
+                for (size_t i = 0; i < element.count; ++i) {
+                    std::memcpy(&mesh.vertices[i], p + i * stride + offsets[x], sizeof(glm::vec3));
+                }
+            } else {
+                for (size_t i = 0; i < element.count; ++i) {
+                    const char* record = p + i * stride;
+                    mesh.vertices[i] = glm::vec3(
+                        static_cast<float>(readValue(record + offsets[x], props[x].type, swap)),
+                        static_cast<float>(readValue(record + offsets[y], props[y].type, swap)),
+                        static_cast<float>(readValue(record + offsets[z], props[z].type, swap)));
+                }
+            }
+
+            if (nx >= 0 && ny >= 0 && nz >= 0) {
+                mesh.normals.resize(element.count);
+                for (size_t i = 0; i < element.count; ++i) {
+                    const char* record = p + i * stride;
+                    mesh.normals[i] = glm::vec3(
+                        static_cast<float>(readValue(record + offsets[nx], props[nx].type, swap)),
+                        static_cast<float>(readValue(record + offsets[ny], props[ny].type, swap)),
+                        static_cast<float>(readValue(record + offsets[nz], props[nz].type, swap)));
+                }
+            }
+            if (u >= 0 && v >= 0) {
+                mesh.uvs.resize(element.count);
+                for (size_t i = 0; i < element.count; ++i) {
+                    const char* record = p + i * stride;
+                    mesh.uvs[i] = glm::vec2(
+                        static_cast<float>(readValue(record + offsets[u], props[u].type, swap)),
+                        static_cast<float>(readValue(record + offsets[v], props[v].type, swap)));
+                }
+            }
+
+            p += element.count * stride;
+        } else if (element.name == "face") {
+            int list = -1;
+            for (size_t i = 0; i < element.properties.size(); ++i) {
+                const auto& property = element.properties[i];
+                if (property.is_list && (property.name == "vertex_indices" || property.name == "vertex_index")) {
+                    list = static_cast<int>(i);
+                }
+            }
+            if (list < 0) {
+                std::cerr << "PlyLoader: face element has no vertex_indices list" << std::endl;
+                return false;
+            }
+
+            const PlyProperty& indices = element.properties[list];
+            const bool packed_triangles = element.properties.size() == 1 && !swap &&
+                                          indices.count_type == PlyType::Uint8 &&
+                                          (indices.type == PlyType::Int32 || indices.type == PlyType::Uint32);
+            mesh.vertex_indices.reserve(element.count * 3);
+
+            std::vector<unsigned int> polygon;
+            for (size_t f = 0; f < element.count; ++f) {
+                if (packed_triangles && p + 13 <= end && static_cast<unsigned char>(*p) == 3) {
+                    // Common case: uchar count followed by three 32-bit indices
+                    size_t base = mesh.vertex_indices.size();
+                    mesh.vertex_indices.resize(base + 3);
+                    std::memcpy(&mesh.vertex_indices[base], p + 1, 12);
+                    p += 13;
+                    continue;
+                }
+
+                for (size_t i = 0; i < element.properties.size(); ++i) {
+                    const PlyProperty& property = element.properties[i];
+                    if (static_cast<int>(i) != list) {
+                        p = skipProperty(p, end, property, swap);
+                        if (!p) break;
+                        continue;
+                    }
+                    if (p + typeSize(property.count_type) > end) {
+                        p = nullptr;
+                        break;
+                    }
+                    size_t count = static_cast<size_t>(readValue(p, property.count_type, swap));
+                    p += typeSize(property.count_type);
+                    if (p + count * typeSize(property.type) > end) {
+                        p = nullptr;
+                        break;
+                    }
+                    polygon.resize(count);
+                    for (size_t k = 0; k < count; ++k) {
+                        polygon[k] = static_cast<unsigned int>(readValue(p, property.type, swap));
+                        p += typeSize(property.type);
+                    }
+                    // Fan triangulation
+                    for (size_t k = 1; k + 1 < count; ++k) {
+                        mesh.vertex_indices.push_back(polygon[0]);
+                        mesh.vertex_indices.push_back(polygon[k]);
+                        mesh.vertex_indices.push_back(polygon[k + 1]);
+                    }
+                }
+                if (!p) {
+                    std::cerr << "PlyLoader: truncated face data in " << path << std::endl;
+                    return false;
+                }
+            }
+        } else {
+            // Skip elements we do not use (edges, materials, ...)
+            if (stride > 0) {
+                if (element.count > static_cast<size_t>(end - p) / stride) {
+                    std::cerr << "PlyLoader: truncated " << element.name << " data in " << path << std::endl;
+                    return false;
+                }
+                p += element.count * stride;
+            } else {
+                for (size_t i = 0; i < element.count && p; ++i) {
+                    for (const auto& property : element.properties) {
+                        p = skipProperty(p, end, property, swap);
+                        if (!p) break;
+                    }
+                }
+                if (!p) {
+                    std::cerr << "PlyLoader: truncated " << element.name << " data in " << path << std::endl;
+                    return false;
+                }
+            }
+        }
+    }
+
+    for (unsigned int index : mesh.vertex_indices) {
+        if (index >= mesh.vertices.size()) {
+            std::cerr << "PlyLoader: face index out of range in " << path << std::endl;
+            return false;
+        }
+    }
+
+    // Per-vertex attributes share the position indices
+    if (!mesh.uvs.empty()) {
+        mesh.uv_indices = mesh.vertex_indices;
+    }
+    if (!mesh.normals.empty()) {
+        mesh.normal_indices = mesh.vertex_indices;
+    }
+
+    return true;
+}
@@ -0,0 +1,16 @@
+#ifndef PLYLOADER_H
+#define PLYLOADER_H
+
+#include "Mesh.h"
+#include "ObjLoader.h"
+#include <string>
+
+// Binary (little- and big-endian) PLY reader. Vertex positions, normals and
+// texture coordinates are shared per vertex; polygons are fan-triangulated.
+class PlyLoader
+{
+public:
+    static bool load(const std::string& path, Mesh& mesh, const MeshLoadOptions& options = MeshLoadOptions());
+};
+
+#endif // PLYLOADER_H
@@ -0,0 +1,120 @@
+#include "StlLoader.h"
+#include "MappedFile.h"
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+const size_t STL_HEADER_SIZE = 80;
+const size_t STL_TRIANGLE_SIZE = 50; // normal, 3 vertices, attribute byte count
+
+static bool hostIsLittleEndian()
+{
+    const uint16_t probe = 1;
+    unsigned char first;
+    std::memcpy(&first, &probe, 1);
+    return first == 1;
+}
+
+static float readFloatLE(const char* p)
+{
+    unsigned char b[4];
+    std::memcpy(b, p, 4);
+    uint32_t bits = uint32_t(b[0]) | (uint32_t(b[1]) << 8) | (uint32_t(b[2]) << 16) | (uint32_t(b[3]) << 24);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static uint32_t readUint32LE(const char* p)
+{
+    unsigned char b[4];
+    std::memcpy(b, p, 4);
+    return uint32_t(b[0]) | (uint32_t(b[1]) << 8) | (uint32_t(b[2]) << 16) | (uint32_t(b[3]) << 24);
+}
+
+bool StlLoader::isBinaryStl(const char* data, size_t size)
+{
+    if (size < STL_HEADER_SIZE + 4) {
+        return false;
+    }
+    uint64_t count = readUint32LE(data + STL_HEADER_SIZE);
+    return size == STL_HEADER_SIZE + 4 + count * STL_TRIANGLE_SIZE;
+}
+
+bool StlLoader::load(const std::string& path, Mesh& mesh, const MeshLoadOptions& options)
+{
+    mesh.vertices.clear();
+    mesh.uvs.clear();
+    mesh.normals.clear();
+    mesh.vertex_indices.clear();
+    mesh.uv_indices.clear();
+    mesh.normal_indices.clear();
+
+    MappedFile file;
+    if (!file.open(path)) {
+        std::cerr << "StlLoader: cannot open " << path << std::endl;
+        return false;
+    }
+    if (!isBinaryStl(file.data(), file.size())) {
+        std::cerr << "StlLoader: " << path << " is not a binary STL file" << std::endl;
+        return false;
+    }
+
+    const size_t num_triangles = readUint32LE(file.data() + STL_HEADER_SIZE);
+    const char* records = file.data() + STL_HEADER_SIZE + 4;
+
+    mesh.vertices.resize(num_triangles * 3);
+    if (options.keep_normals) {
+        mesh.normals.resize(num_triangles);
+    }
+
+    if (hostIsLittleEndian()) {
+        // The three corner positions of a facet are contiguous in the record
+        for (size_t t = 0; t < num_triangles; ++t) {
+            const char* record = records + t * STL_TRIANGLE_SIZE;
+            std::memcpy(&mesh.vertices[t * 3], record + 12, 3 * sizeof(glm::vec3));
+            if (options.keep_normals) {
+                std::memcpy(&mesh.normals[t], record, sizeof(glm::vec3));
+            }
+        }
+    } else {
+        for (size_t t = 0; t < num_triangles; ++t) {
+            const char* record = records + t * STL_TRIANGLE_SIZE;
+            for (int c = 0; c < 3; ++c) {
+                const char* p = record + 12 + c * 12;
+                mesh.vertices[t * 3 + c] = glm::vec3(readFloatLE(p), readFloatLE(p + 4), readFloatLE(p + 8));
+            }
+            if (options.keep_normals) {
+                mesh.normals[t] = glm::vec3(readFloatLE(record), readFloatLE(record + 4), readFloatLE(record + 8));
+            }
+        }
+    }
+
+    // The de-indexed layout uses a trivial index sequence
+    mesh.vertex_indices.resize(mesh.vertices.size());
+    for (size_t i = 0; i < mesh.vertex_indices.size(); ++i) {
+        mesh.vertex_indices[i] = i;
+    }
+
+    if (options.keep_normals) {
+        // Facet normals are stored once per face. Many exporters write zero
+        // normals; then all of them are left to Mesh::ensureNormals.
+        bool valid = true;
+        for (const auto& normal : mesh.normals) {
+            if (normal == glm::vec3(0.0f, 0.0f, 0.0f)) {
+                valid = false;
+                break;
+            }
+        }
+        if (valid) {
+            mesh.normal_indices.resize(mesh.vertex_indices.size());
+            for (size_t i = 0; i < mesh.normal_indices.size(); ++i) {
+                mesh.normal_indices[i] = static_cast<unsigned int>(i / 3);
+            }
+        } else {
+            mesh.normals.clear();
+        }
+    }
+
+    return true;
+}
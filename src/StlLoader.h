@@ -0,0 +1,17 @@
+#ifndef STLLOADER_H
+#define STLLOADER_H
+
+#include "Mesh.h"
+#include "ObjLoader.h"
+#include <string>
+
+// Binary STL reader. STL is a triangle soup, so the mesh is filled in the same
+// de-indexed layout as ObjLoader::load_indexed, with one normal per facet.
+class StlLoader
+{
+public:
+    static bool load(const std::string& path, Mesh& mesh, const MeshLoadOptions& options = MeshLoadOptions());
+    static bool isBinaryStl(const char* data, size_t size);
+};
+
+#endif // STLLOADER_H
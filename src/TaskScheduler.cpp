@@ -0,0 +1,284 @@
+#include "TaskScheduler.h"
+
+namespace {
+
+// Index of the worker running on this thread, or -1 on other threads
+thread_local long current_worker = -1;
+
+} // namespace
+
+TaskScheduler& TaskScheduler::getInstance()
+{
+    static TaskScheduler instance;
+    return instance;
+}
+
+TaskScheduler::TaskScheduler()
+{
+    start(0);
+}
+
+TaskScheduler::~TaskScheduler()
+{
+    stop();
+}
+
+bool TaskScheduler::onWorkerThread()
+{
+    return current_worker >= 0;
+}
+
+void TaskScheduler::setThreadCount(unsigned int count)
+{
+    if (onWorkerThread()) {
+        return;
+    }
+    if (count == 0) {
+        count = std::thread::hardware_concurrency();
+    }
+    std::lock_guard<std::mutex> lock(config_mutex);
+    if (count == thread_count) {
+        return;
+    }
+    {
+        std::unique_lock<std::mutex> state_lock(state_mutex);
+        resizing = true;
+        state_changed.wait(state_lock, [&]() { return active == 0; });
+    }
+    restart(count);
+}
+
+bool TaskScheduler::trySetThreadCount(unsigned int count)
+{
+    if (onWorkerThread()) {
+        return false;
+    }
+    if (count == 0) {
+        count = std::thread::hardware_concurrency();
+    }
+    std::unique_lock<std::mutex> lock(config_mutex, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        return false;
+    }
+    if (count == thread_count) {
+        return true;
+    }
+    {
+        std::lock_guard<std::mutex> state_lock(state_mutex);
+        if (active != 0) {
+            return false;
+        }
+        resizing = true;
+    }
+    restart(count);
+    return true;
+}
+
+void TaskScheduler::restart(unsigned int count)
+{
+    stop();
+    start(count);
+    {
+        std::lock_guard<std::mutex> state_lock(state_mutex);
+        resizing = false;
+    }
+    state_changed.notify_all();
+}
+
+void TaskScheduler::start(unsigned int count)
+{
+    if (count == 0) {
+        count = std::thread::hardware_concurrency();
+    }
+    count = count == 0 ? 1 : count;
+
+    queues.clear();
+    for (unsigned int i = 0; i <= count; ++i) {
+        queues.emplace_back(new WorkQueue);
+    }
+    stopping = false;
+    thread_count = count;
+    workers.reserve(count);
+    for (unsigned int i = 0; i < count; ++i) {
+        workers.emplace_back(&TaskScheduler::workerLoop, this, static_cast<size_t>(i));
+    }
+}
+
+// Workers drain the queues before they exit
+void TaskScheduler::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+}
+
+void TaskScheduler::workerLoop(size_t index)
+{
+    current_worker = static_cast<long>(index);
+    Task task;
+    while (true) {
+        if (take(task, nullptr)) {
+            execute(task);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleep_mutex);
+        wake.wait(lock, [&]() { return queued > 0 || stopping; });
+        if (stopping && queued == 0) {
+            return;
+        }
+    }
+}
+
+void TaskScheduler::submit(Task&& task)
+{
+    {
+        // Tasks submitted by running tasks keep a resize waiting anyway, so
+        // only outside submissions hold off until the workers are back
+        std::unique_lock<std::mutex> lock(state_mutex);
+        if (current_worker < 0) {
+            state_changed.wait(lock, [&]() { return !resizing; });
+        }
+        ++active;
+    }
+    const size_t index = current_worker >= 0 ? static_cast<size_t>(current_worker) : queues.size() - 1;
+    {
+        std::lock_guard<std::mutex> lock(queues[index]->mutex);
+        queues[index]->tasks.push_back(std::move(task));
+    }
+    // Taking the lock orders the increment before a worker's wait predicate
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        ++queued;
+    }
+    wake.notify_one();
+}
+
+bool TaskScheduler::take(Task& task, const TaskGroup* group)
+{
+    const size_t num_queues = queues.size();
+    const size_t self = current_worker >= 0 ? static_cast<size_t>(current_worker) : num_queues - 1;
+    for (size_t n = 0; n < num_queues; ++n) {
+        const size_t index = (self + n) % num_queues;
+        const bool own = n == 0 && current_worker >= 0;
+        WorkQueue& queue = *queues[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) {
+            continue;
+        }
+        if (!group) {
+            if (own) {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            } else {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+            --queued;
+            return true;
+        }
+        // Group tasks are few and usually near the back of the queue
+        for (auto it = queue.tasks.end(); it != queue.tasks.begin();) {
+            --it;
+            if (it->group == group) {
+                task = std::move(*it);
+                queue.tasks.erase(it);
+                --queued;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void TaskScheduler::execute(Task& task)
+{
+    std::exception_ptr error;
+    try {
+        task.function();
+    } catch (...) {
+        error = std::current_exception();
+    }
+    // Release captures before the group can see the task as finished
+    task.function = nullptr;
+    TaskGroup* group = task.group;
+    task.group = nullptr;
+    group->finish(error);
+
+    bool idle;
+    {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        idle = --active == 0 && resizing;
+    }
+    if (idle) {
+        state_changed.notify_all();
+    }
+}
+
+TaskGroup::~TaskGroup()
+{
+    try {
+        wait();
+    } catch (...) {
+    }
+}
+
+void TaskGroup::run(std::function<void()> function)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++pending;
+        ++generation;
+    }
+    changed.notify_all();
+    TaskScheduler::Task task;
+    task.function = std::move(function);
+    task.group = this;
+    TaskScheduler::getInstance().submit(std::move(task));
+}
+
+void TaskGroup::wait()
+{
+    TaskScheduler& scheduler = TaskScheduler::getInstance();
+    const bool help = TaskScheduler::onWorkerThread();
+    TaskScheduler::Task task;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (pending > 0) {
+        const size_t seen = generation;
+        if (help) {
+            lock.unlock();
+            const bool found = scheduler.take(task, this);
+            if (found) {
+                scheduler.execute(task);
+            }
+            lock.lock();
+            if (found) {
+                continue;
+            }
+        }
+        // Our tasks are all running elsewhere; sleep until one finishes or a
+        // running task adds another
+        changed.wait(lock, [&]() { return pending == 0 || generation != seen; });
+    }
+    if (first_error) {
+        std::exception_ptr error = first_error;
+        first_error = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+void TaskGroup::finish(std::exception_ptr error)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (error && !first_error) {
+        first_error = error;
+    }
+    --pending;
+    ++generation;
+    changed.notify_all();
+}
@@ -0,0 +1,126 @@
+#ifndef TASKSCHEDULER_H
+#define TASKSCHEDULER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class TaskGroup;
+
+// Process-wide pool of worker threads shared by every parallel layer: batch
+// file jobs, the checks of one mesh and the loops inside each check all run
+// as tasks here, so the thread count set once is the number of threads doing
+// work.
+//
+// Each worker owns a deque. Tasks submitted from a worker go to the back of
+// its own deque and are taken from there (newest first, still in cache);
+// idle workers steal from the front of the others. Tasks submitted from
+// other threads go to a shared queue that every worker steals from.
+class TaskScheduler
+{
+public:
+    static TaskScheduler& getInstance();
+
+    // Restarts the workers with the given count (0 means one per hardware
+    // thread). Blocks until every submitted task has finished; submissions
+    // from other threads wait meanwhile. Does nothing on a worker thread,
+    // whose own task could never finish.
+    void setThreadCount(unsigned int count);
+    // Same, but only if no task is running or queued; otherwise returns false
+    // at once and keeps the current workers. For callers that must not block,
+    // like the GUI thread.
+    bool trySetThreadCount(unsigned int count);
+    unsigned int threadCount() const { return thread_count; }
+
+    // True on the scheduler's own worker threads
+    static bool onWorkerThread();
+
+private:
+    friend class TaskGroup;
+
+    struct Task {
+        std::function<void()> function;
+        TaskGroup* group = nullptr;
+    };
+
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    TaskScheduler();
+    ~TaskScheduler();
+    TaskScheduler(const TaskScheduler&) = delete;
+    void operator=(const TaskScheduler&) = delete;
+
+    void start(unsigned int count);
+    void stop();
+    // Restarts the workers once resizing is set and no task is active
+    void restart(unsigned int count);
+    void workerLoop(size_t index);
+
+    void submit(Task&& task);
+    // Takes a task from the worker's own queue or steals one. With a group,
+    // only tasks of that group are taken.
+    bool take(Task& task, const TaskGroup* group);
+    void execute(Task& task);
+
+    // One queue per worker, then the shared queue for outside submissions
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<unsigned int> thread_count{0};
+
+    std::atomic<size_t> queued{0};
+    std::mutex sleep_mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+    std::mutex config_mutex;
+
+    // Tasks submitted and not yet finished, and whether a resize is waiting
+    // for them to reach zero
+    size_t active = 0;
+    bool resizing = false;
+    std::mutex state_mutex;
+    std::condition_variable state_changed;
+};
+
+// Tasks that are waited for together. A worker thread that waits runs the
+// group's queued tasks itself instead of blocking, and only those, so a
+// thread waiting inside one file job never picks up another file job.
+class TaskGroup
+{
+public:
+    TaskGroup() = default;
+    // Waits for the remaining tasks; exceptions are dropped here
+    ~TaskGroup();
+
+    void run(std::function<void()> function);
+
+    // Returns once every task has finished, and rethrows the first exception
+    // a task threw.
+    void wait();
+
+private:
+    friend class TaskScheduler;
+
+    TaskGroup(const TaskGroup&) = delete;
+    void operator=(const TaskGroup&) = delete;
+
+    void finish(std::exception_ptr error);
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    size_t pending = 0;
+    // Bumped whenever a task is added or finishes, to wake waiters
+    size_t generation = 0;
+    std::exception_ptr first_error;
+};
+
+#endif // TASKSCHEDULER_H
@@ -0,0 +1,209 @@
+#include "TopologyEngine.h"
+#include "CompactMesh.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+
+namespace {
+
+// One face edge, keyed by its unordered vertex pair
+struct EdgeRecord {
+    uint64_t key;        // Smaller vertex in the high bits, larger in the low
+    unsigned int corner; // 3 * face + k: the edge from corner k to the next
+};
+
+inline unsigned int nextCorner(unsigned int corner)
+{
+    return corner % 3 == 2 ? corner - 2 : corner + 1;
+}
+
+// Face corners joined across manifold edges. The corners of one set share a
+// vertex and make up one fan of faces around it.
+struct CornerSets {
+    std::vector<unsigned int> parent;
+
+    explicit CornerSets(size_t count) : parent(count)
+    {
+        std::iota(parent.begin(), parent.end(), 0u);
+    }
+
+    unsigned int find(unsigned int corner)
+    {
+        while (parent[corner] != corner) {
+            parent[corner] = parent[parent[corner]];
+            corner = parent[corner];
+        }
+        return corner;
+    }
+
+    void unite(unsigned int a, unsigned int b)
+    {
+        a = find(a);
+        b = find(b);
+        if (a != b) {
+            parent[std::max(a, b)] = std::min(a, b);
+        }
+    }
+};
+
+TopologyEngine::Result analyzeIndices(const unsigned int* indices, size_t index_count, size_t vertex_count)
+{
+    TopologyEngine::Result result;
+    const size_t num_faces = index_count / 3;
+    if (num_faces == 0 || vertex_count == 0) {
+        result.is_closed = true;
+        return result;
+    }
+
+    std::vector<unsigned char> valid(num_faces);
+    Parallel::forRange(num_faces, 1 << 16, [&](size_t begin, size_t end) {
+        for (size_t f = begin; f < end; ++f) {
+            const unsigned int a = indices[3 * f], b = indices[3 * f + 1], c = indices[3 * f + 2];
+            valid[f] = a < vertex_count && b < vertex_count && c < vertex_count && a != b && b != c && a != c;
+        }
+    });
+    std::vector<size_t> first_edge(num_faces + 1, 0);
+    for (size_t f = 0; f < num_faces; ++f) {
+        first_edge[f + 1] = first_edge[f] + (valid[f] ? 3 : 0);
+    }
+
+    unsigned int vertex_bits = 1;
+    while (vertex_bits < 32 && ((vertex_count - 1) >> vertex_bits) != 0) {
+        ++vertex_bits;
+    }
+
+    // The edge table: every face edge, sorted so the uses of one edge are
+    // adjacent and in face order
+    std::vector<EdgeRecord> edges(first_edge[num_faces]);
+    Parallel::forRange(num_faces, 1 << 16, [&](size_t begin, size_t end) {
+        for (size_t f = begin; f < end; ++f) {
+            if (!valid[f]) {
+                continue;
+            }
+            for (unsigned int k = 0; k < 3; ++k) {
+                const unsigned int corner = static_cast<unsigned int>(3 * f + k);
+                const uint64_t a = indices[corner], b = indices[nextCorner(corner)];
+                edges[first_edge[f] + k] = {(std::min(a, b) << vertex_bits) | std::max(a, b), corner};
+            }
+        }
+    });
+    {
+        std::vector<EdgeRecord> scratch;
+        Parallel::radixSort(edges, scratch, 2 * vertex_bits, [](const EdgeRecord& edge) { return edge.key; });
+    }
+
+    CornerSets fans(3 * num_faces);
+    std::vector<unsigned char> on_non_manifold_edge(vertex_count, 0);
+    std::vector<unsigned int> border_corners;
+    for (size_t i = 0; i < edges.size();) {
+        size_t j = i + 1;
+        while (j < edges.size() && edges[j].key == edges[i].key) {
+            ++j;
+        }
+        ++result.edges_count;
+        if (j - i == 1) {
+            border_corners.push_back(edges[i].corner);
+        } else if (j - i == 2) {
+            // Join the two faces' corners at each end of the edge
+            const unsigned int h = edges[i].corner, g = edges[i + 1].corner;
+            const bool same_direction = indices[g] == indices[h];
+            fans.unite(h, same_direction ? g : nextCorner(g));
+            fans.unite(nextCorner(h), same_direction ? nextCorner(g) : g);
+        } else {
+            ++result.non_manifold_edges_count;
+            on_non_manifold_edge[indices[edges[i].corner]] = 1;
+            on_non_manifold_edge[indices[nextCorner(edges[i].corner)]] = 1;
+            for (size_t k = i; k < j; ++k) {
+                result.non_manifold_faces.push_back(edges[k].corner / 3);
+            }
+        }
+        i = j;
+    }
+    result.border_edges_count = border_corners.size();
+    result.is_closed = result.border_edges_count == 0 && result.non_manifold_edges_count == 0;
+    edges = std::vector<EdgeRecord>();
+
+    // Fans per vertex: the sets whose root corner is at that vertex
+    std::vector<unsigned int> fan_count(vertex_count, 0);
+    for (unsigned int corner = 0; corner < 3 * num_faces; ++corner) {
+        if (valid[corner / 3] && fans.find(corner) == corner) {
+            ++fan_count[indices[corner]];
+        }
+    }
+    for (size_t v = 0; v < vertex_count; ++v) {
+        if (fan_count[v] > 1 || on_non_manifold_edge[v]) {
+            ++result.non_manifold_vertices_count;
+        }
+    }
+    for (unsigned int corner = 0; corner < 3 * num_faces; ++corner) {
+        const unsigned int v = indices[corner];
+        if (valid[corner / 3] && fans.parent[corner] == corner && (fan_count[v] > 1 || on_non_manifold_edge[v])) {
+            result.non_manifold_faces.push_back(corner / 3);
+        }
+    }
+    std::sort(result.non_manifold_faces.begin(), result.non_manifold_faces.end());
+    result.non_manifold_faces.erase(std::unique(result.non_manifold_faces.begin(), result.non_manifold_faces.end()),
+                                    result.non_manifold_faces.end());
+
+    // Border edges around each vertex, to walk the loops. Walks ignore the
+    // edge direction so loops along inconsistently oriented faces close too.
+    const size_t num_border = border_corners.size();
+    std::vector<unsigned int> border_start(vertex_count + 1, 0);
+    for (unsigned int corner : border_corners) {
+        ++border_start[indices[corner] + 1];
+        ++border_start[indices[nextCorner(corner)] + 1];
+    }
+    std::partial_sum(border_start.begin(), border_start.end(), border_start.begin());
+    std::vector<unsigned int> cursor(border_start.begin(), border_start.end() - 1);
+    std::vector<unsigned int> border_at(2 * num_border);
+    for (unsigned int e = 0; e < num_border; ++e) {
+        border_at[cursor[indices[border_corners[e]]]++] = e;
+        border_at[cursor[indices[nextCorner(border_corners[e])]]++] = e;
+    }
+    std::copy(border_start.begin(), border_start.end() - 1, cursor.begin());
+
+    std::vector<unsigned char> walked(num_border, 0);
+    for (unsigned int e = 0; e < num_border; ++e) {
+        if (walked[e]) {
+            continue;
+        }
+        walked[e] = 1;
+        const unsigned int start = indices[border_corners[e]];
+        unsigned int current = indices[nextCorner(border_corners[e])];
+        std::vector<unsigned int> loop = {start};
+        while (current != start) {
+            loop.push_back(current);
+            // Skip the edges at this vertex that were walked already
+            while (cursor[current] < border_start[current + 1] && walked[border_at[cursor[current]]]) {
+                ++cursor[current];
+            }
+            if (cursor[current] == border_start[current + 1]) {
+                break; // Open chain, ends at a non-manifold edge
+            }
+            const unsigned int next = border_at[cursor[current]];
+            walked[next] = 1;
+            const unsigned int a = indices[border_corners[next]], b = indices[nextCorner(border_corners[next])];
+            current = a == current ? b : a;
+        }
+        result.border_loops.push_back(std::move(loop));
+    }
+
+    return result;
+}
+
+} // namespace
+
+TopologyEngine::Result TopologyEngine::analyze(const Mesh& mesh)
+{
+    return analyzeIndices(mesh.vertex_indices.data(), mesh.vertex_indices.size(), mesh.vertices.size());
+}
+
+TopologyEngine::Result TopologyEngine::analyze(const CompactMesh& mesh)
+{
+    if (!mesh.hasShortIndices()) {
+        return analyzeIndices(mesh.indices.data(), mesh.indices.size(), mesh.vertexCount());
+    }
+    std::vector<unsigned int> indices(mesh.short_indices.begin(), mesh.short_indices.end());
+    return analyzeIndices(indices.data(), indices.size(), mesh.vertexCount());
+}
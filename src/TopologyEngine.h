@@ -0,0 +1,42 @@
+#ifndef TOPOLOGYENGINE_H
+#define TOPOLOGYENGINE_H
+
+#include "Mesh.h"
+#include <cstddef>
+#include <vector>
+
+struct CompactMesh;
+
+// Topology of the indexed input without building a CGAL halfedge mesh. One
+// table of the mesh edges, radix sorted by vertex pair, gives the faces
+// around every edge; closedness, non-manifold edges and vertices and the
+// border loops all come from it in linear time.
+//
+// Faces are taken as they are: there is no soup repair, so results can
+// differ from the CGAL path on meshes that repair would change. Faces with
+// repeated or out-of-range indices are skipped, as the CGAL path drops them.
+class TopologyEngine
+{
+public:
+    struct Result {
+        // No border and no non-manifold edges
+        bool is_closed = false;
+        size_t edges_count = 0;
+        size_t border_edges_count = 0;       // Used by one face
+        size_t non_manifold_edges_count = 0; // Used by more than two faces
+        // Vertices whose faces form more than one fan, or that lie on a
+        // non-manifold edge
+        size_t non_manifold_vertices_count = 0;
+
+        // One face of each fan around the non-manifold vertices and the faces
+        // of the non-manifold edges, sorted
+        std::vector<unsigned int> non_manifold_faces;
+        // Vertex indices around each loop of border edges
+        std::vector<std::vector<unsigned int>> border_loops;
+    };
+
+    static Result analyze(const Mesh& mesh);
+    static Result analyze(const CompactMesh& mesh);
+};
+
+#endif // TOPOLOGYENGINE_H
@@ -0,0 +1,152 @@
+#include "TriangleFilter.h"
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TRIANGLEFILTER_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+// Shewchuk's orient3d bound (7 + 56e)e for float arithmetic, e = 2^-24,
+// rounded up. It covers the rounded coordinate differences too.
+const float ORIENT_ERROR_BOUND = 4.2e-7f;
+
+// Below this the products may have lost bits to underflow and the bound
+// no longer holds
+const float MIN_PERMANENT = 1e-30f;
+
+// Signed volume of (w - a, b - a, c - a) and its error bound. Written with
+// only +, -, * and fabs so the SIMD version computes the same values.
+inline void orient(const float* a, const float* b, const float* c, const float* w, float& det, float& bound)
+{
+    const float ux = b[0] - a[0], uy = b[1] - a[1], uz = b[2] - a[2];
+    const float vx = c[0] - a[0], vy = c[1] - a[1], vz = c[2] - a[2];
+    const float wx = w[0] - a[0], wy = w[1] - a[1], wz = w[2] - a[2];
+    const float uyvz = uy * vz, uzvy = uz * vy;
+    const float uzvx = uz * vx, uxvz = ux * vz;
+    const float uxvy = ux * vy, uyvx = uy * vx;
+    det = wx * (uyvz - uzvy) + wy * (uzvx - uxvz) + wz * (uxvy - uyvx);
+    const float permanent = std::fabs(wx) * (std::fabs(uyvz) + std::fabs(uzvy))
+                          + std::fabs(wy) * (std::fabs(uzvx) + std::fabs(uxvz))
+                          + std::fabs(wz) * (std::fabs(uxvy) + std::fabs(uyvx));
+    bound = permanent < MIN_PERMANENT ? std::numeric_limits<float>::infinity() : ORIENT_ERROR_BOUND * permanent;
+}
+
+// True if all of 'other' lies strictly on one side of the plane of 't'
+inline bool separatedByPlane(const TriangleFilter::Triangle& t, const TriangleFilter::Triangle& other)
+{
+    int positive = 0, negative = 0;
+    for (int k = 0; k < 3; ++k) {
+        float det, bound;
+        orient(t.p[0], t.p[1], t.p[2], other.p[k], det, bound);
+        positive += det > bound;
+        negative += det < -bound;
+    }
+    return positive == 3 || negative == 3;
+}
+
+#ifdef TRIANGLEFILTER_SSE2
+
+// Vertex k, axis 'axis' of four triangles in one register
+struct Lanes {
+    __m128 p[3][3];
+};
+
+inline void gather(const TriangleFilter::Triangle* t[4], Lanes& lanes)
+{
+    for (int k = 0; k < 3; ++k) {
+        for (int axis = 0; axis < 3; ++axis) {
+            lanes.p[k][axis] = _mm_setr_ps(t[0]->p[k][axis], t[1]->p[k][axis], t[2]->p[k][axis], t[3]->p[k][axis]);
+        }
+    }
+}
+
+inline __m128 absolute(__m128 x)
+{
+    return _mm_andnot_ps(_mm_set1_ps(-0.0f), x);
+}
+
+// Lane mask of the pairs whose 'other' lies strictly on one side of 't'
+__m128 separatedByPlane4(const Lanes& t, const Lanes& other)
+{
+    const __m128 ux = _mm_sub_ps(t.p[1][0], t.p[0][0]), uy = _mm_sub_ps(t.p[1][1], t.p[0][1]), uz = _mm_sub_ps(t.p[1][2], t.p[0][2]);
+    const __m128 vx = _mm_sub_ps(t.p[2][0], t.p[0][0]), vy = _mm_sub_ps(t.p[2][1], t.p[0][1]), vz = _mm_sub_ps(t.p[2][2], t.p[0][2]);
+    const __m128 uyvz = _mm_mul_ps(uy, vz), uzvy = _mm_mul_ps(uz, vy);
+    const __m128 uzvx = _mm_mul_ps(uz, vx), uxvz = _mm_mul_ps(ux, vz);
+    const __m128 uxvy = _mm_mul_ps(ux, vy), uyvx = _mm_mul_ps(uy, vx);
+    const __m128 nx = _mm_sub_ps(uyvz, uzvy), ny = _mm_sub_ps(uzvx, uxvz), nz = _mm_sub_ps(uxvy, uyvx);
+    const __m128 px = _mm_add_ps(absolute(uyvz), absolute(uzvy));
+    const __m128 py = _mm_add_ps(absolute(uzvx), absolute(uxvz));
+    const __m128 pz = _mm_add_ps(absolute(uxvy), absolute(uyvx));
+    const __m128 error = _mm_set1_ps(ORIENT_ERROR_BOUND);
+    const __m128 min_permanent = _mm_set1_ps(MIN_PERMANENT);
+
+    __m128 all_positive = _mm_castsi128_ps(_mm_set1_epi32(-1));
+    __m128 all_negative = all_positive;
+    for (int k = 0; k < 3; ++k) {
+        const __m128 wx = _mm_sub_ps(other.p[k][0], t.p[0][0]);
+        const __m128 wy = _mm_sub_ps(other.p[k][1], t.p[0][1]);
+        const __m128 wz = _mm_sub_ps(other.p[k][2], t.p[0][2]);
+        const __m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(wx, nx), _mm_mul_ps(wy, ny)), _mm_mul_ps(wz, nz));
+        const __m128 permanent = _mm_add_ps(_mm_add_ps(_mm_mul_ps(absolute(wx), px), _mm_mul_ps(absolute(wy), py)),
+                                            _mm_mul_ps(absolute(wz), pz));
+        // Lanes with an underflowed permanent get no certain sign
+        const __m128 valid = _mm_cmpge_ps(permanent, min_permanent);
+        const __m128 bound = _mm_mul_ps(error, permanent);
+        all_positive = _mm_and_ps(all_positive, _mm_and_ps(valid, _mm_cmpgt_ps(det, bound)));
+        all_negative = _mm_and_ps(all_negative, _mm_and_ps(valid, _mm_cmplt_ps(det, _mm_sub_ps(_mm_setzero_ps(), bound))));
+    }
+    return _mm_or_ps(all_positive, all_negative);
+}
+
+#endif
+
+} // namespace
+
+TriangleFilter::Triangle TriangleFilter::fromDoubles(const double a[3], const double b[3], const double c[3])
+{
+    const double* points[3] = {a, b, c};
+    Triangle t;
+    bool exact = true;
+    for (int k = 0; k < 3; ++k) {
+        for (int axis = 0; axis < 3; ++axis) {
+            t.p[k][axis] = static_cast<float>(points[k][axis]);
+            exact = exact && static_cast<double>(t.p[k][axis]) == points[k][axis] && std::isfinite(t.p[k][axis]);
+        }
+    }
+    if (!exact) {
+        t.p[0][0] = std::numeric_limits<float>::quiet_NaN();
+    }
+    return t;
+}
+
+void TriangleFilter::classify(const Triangle* first, const Triangle* second,
+                              const std::pair<unsigned int, unsigned int>* pairs, size_t count,
+                              unsigned char* may_intersect)
+{
+    size_t i = 0;
+#ifdef TRIANGLEFILTER_SSE2
+    for (; i + 4 <= count; i += 4) {
+        const Triangle* a[4];
+        const Triangle* b[4];
+        for (int lane = 0; lane < 4; ++lane) {
+            a[lane] = &first[pairs[i + lane].first];
+            b[lane] = &second[pairs[i + lane].second];
+        }
+        Lanes lanes_a, lanes_b;
+        gather(a, lanes_a);
+        gather(b, lanes_b);
+        const int separated = _mm_movemask_ps(_mm_or_ps(separatedByPlane4(lanes_a, lanes_b), separatedByPlane4(lanes_b, lanes_a)));
+        for (int lane = 0; lane < 4; ++lane) {
+            may_intersect[i + lane] = !((separated >> lane) & 1);
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        const Triangle& a = first[pairs[i].first];
+        const Triangle& b = second[pairs[i].second];
+        may_intersect[i] = !(separatedByPlane(a, b) || separatedByPlane(b, a));
+    }
+}
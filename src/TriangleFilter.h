@@ -0,0 +1,31 @@
+#ifndef TRIANGLEFILTER_H
+#define TRIANGLEFILTER_H
+
+#include <cstddef>
+#include <utility>
+
+// Float pre-test for the triangle pairs the intersection checks find with
+// their bounding boxes. Pairs are tested four at a time: a pair is rejected
+// when all vertices of one triangle lie strictly on one side of the other
+// triangle's plane, with the orientation signs certified by a forward error
+// bound. Only the pairs it cannot reject need an exact predicate.
+class TriangleFilter
+{
+public:
+    struct Triangle {
+        float p[3][3]; // Vertex, axis
+    };
+
+    // Coordinates that are not exactly floats (mesh positions always are)
+    // make the triangle NaN, which the filter never rejects.
+    static Triangle fromDoubles(const double a[3], const double b[3], const double c[3]);
+
+    // may_intersect[i] = 0 when first[pairs[i].first] and
+    // second[pairs[i].second] certainly do not intersect, 1 otherwise.
+    // first and second may be the same array.
+    static void classify(const Triangle* first, const Triangle* second,
+                         const std::pair<unsigned int, unsigned int>* pairs, size_t count,
+                         unsigned char* may_intersect);
+};
+
+#endif // TRIANGLEFILTER_H
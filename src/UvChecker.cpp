@@ -1,10 +1,10 @@
 #include "UvChecker.h"
+#include "WorkerArena.h"
 #include <vector>
-#include <queue>
 #include <set>
 #include <algorithm>
 #include <cmath>
-#include <map>
+#include <memory_resource>
 
 // --- Configuration ---
 const int GRID_RESOLUTION = 1024; // Trade-off between precision and memory/speed
@@ -20,7 +20,6 @@ struct Edge {
 };
 
 // --- Function Prototypes ---
-void findUVIslands(const Mesh& mesh, std::vector<std::vector<unsigned int>>& islands, std::vector<int>& face_to_island_map);
 bool is_inside(const glm::vec2& p1, const glm::vec2& p2, const glm::vec2& p3, const glm::vec2& test_p);
 
 // --- Public Methods ---
@@ -30,34 +29,40 @@ bool UvChecker::hasUvs(const Mesh& mesh)
     return !mesh.uvs.empty() && !mesh.uv_indices.empty();
 }
 
-int UvChecker::countUvsOutOfBounds(const Mesh& mesh)
+int UvChecker::countUvsOutOfBounds(const Mesh& mesh, const CheckLimit& limit)
 {
+    // Count per face corner so shared and de-indexed UVs give the same result
     int count = 0;
-    for (const auto& uv : mesh.uvs) {
+    for (unsigned int uv_index : mesh.uv_indices) {
+        const glm::vec2& uv = mesh.uvs[uv_index];
         if (uv.x < 0.0f || uv.x > 1.0f || uv.y < 0.0f || uv.y > 1.0f) {
             count++;
+            if (limit.reached(count)) {
+                break;
+            }
         }
     }
     return count;
 }
 
-int UvChecker::countOverlappingUvIslands(const Mesh& mesh, std::vector<unsigned int>& overlapping_faces)
+int UvChecker::countOverlappingUvIslands(const Mesh& mesh, std::vector<unsigned int>& overlapping_faces, WorkerArena* arena, const CheckLimit& limit)
 {
     if (!hasUvs(mesh)) {
         return 0;
     }
+    std::pmr::memory_resource* resource = arena ? arena->resource() : std::pmr::get_default_resource();
 
-    // 1. Find connected UV islands to distinguish between inter-island and intra-island overlaps
-    std::vector<std::vector<unsigned int>> islands;
-    std::vector<int> face_to_island_map(mesh.vertex_indices.size() / 3, -1);
-    findUVIslands(mesh, islands, face_to_island_map);
-
-    // 2. Rasterize each face and check for overlaps at the pixel level
-    std::vector<int> grid(GRID_RESOLUTION * GRID_RESOLUTION, -1); // Stores face_idx, -1 is empty
-    std::set<unsigned int> culprit_faces;
+    // 1. Rasterize each face and check for overlaps at the pixel level
+    std::vector<int> local_grid;
+    std::vector<int>& grid = arena ? arena->uv_grid : local_grid;
+    grid.assign(GRID_RESOLUTION * GRID_RESOLUTION, -1); // Stores face_idx, -1 is empty
+    std::pmr::set<unsigned int> culprit_faces(resource);
 
     int num_faces = mesh.vertex_indices.size() / 3;
-    for (int face_idx = 0; face_idx < num_faces; ++face_idx) {
+    for (int face_idx = 0; face_idx < num_faces && !limit.shouldStop(culprit_faces.size()); ++face_idx) {
+        if (face_idx % 4096 == 0) {
+            limit.report(static_cast<float>(face_idx) / num_faces);
+        }
         glm::vec2 uv1 = mesh.uvs[mesh.uv_indices[face_idx * 3 + 0]];
         glm::vec2 uv2 = mesh.uvs[mesh.uv_indices[face_idx * 3 + 1]];
         glm::vec2 uv3 = mesh.uvs[mesh.uv_indices[face_idx * 3 + 2]];
@@ -88,7 +93,7 @@ int UvChecker::countOverlappingUvIslands(const Mesh& mesh, std::vector<unsigned
         }
     }
 
-    // 3. Populate the output vector with the specific overlapping faces
+    // 2. Populate the output vector with the specific overlapping faces
     overlapping_faces.clear();
     overlapping_faces.assign(culprit_faces.begin(), culprit_faces.end());
 
@@ -100,57 +105,6 @@ int UvChecker::countOverlappingUvIslands(const Mesh& mesh, std::vector<unsigned
 
 // --- Private Helper Implementations ---
 
-void findUVIslands(const Mesh& mesh, std::vector<std::vector<unsigned int>>& islands, std::vector<int>& face_to_island_map) {
-    int num_faces = mesh.vertex_indices.size() / 3;
-    std::vector<bool> visited(num_faces, false);
-    std::vector<std::vector<int>> adj(num_faces);
-
-    // Build adjacency list based on shared UV vertices
-    std::map<unsigned int, std::vector<unsigned int>> uv_to_face_map;
-    for(int i = 0; i < num_faces; ++i) {
-        for(int j = 0; j < 3; ++j) {
-            uv_to_face_map[mesh.uv_indices[i*3 + j]].push_back(i);
-        }
-    }
-
-    for(auto const& [uv_idx, faces] : uv_to_face_map) {
-        for(size_t i = 0; i < faces.size(); ++i) {
-            for(size_t j = i + 1; j < faces.size(); ++j) {
-                adj[faces[i]].push_back(faces[j]);
-                adj[faces[j]].push_back(faces[i]);
-            }
-        }
-    }
-
-    // Find connected components (islands) using BFS
-    for (int i = 0; i < num_faces; ++i) {
-        if (!visited[i]) {
-            std::vector<unsigned int> current_island;
-            std::queue<int> q;
-
-            q.push(i);
-            visited[i] = true;
-            int island_id = islands.size();
-            face_to_island_map[i] = island_id;
-
-            while (!q.empty()) {
-                int u = q.front();
-                q.pop();
-                current_island.push_back(u);
-
-                for (int v : adj[u]) {
-                    if (!visited[v]) {
-                        visited[v] = true;
-                        face_to_island_map[v] = island_id;
-                        q.push(v);
-                    }
-                }
-            }
-            islands.push_back(current_island);
-        }
-    }
-}
-
 // Barycentric coordinate check
 float sign(const glm::vec2& p1, const glm::vec2& p2, const glm::vec2& p3) {
     return (p1.x - p3.x) * (p2.y - p3.y) - (p2.x - p3.x) * (p1.y - p3.y);
@@ -2,14 +2,20 @@
 #define UVCHECKER_H
 
 #include "Mesh.h"
+#include "CheckLimit.h"
 #include <vector>
 
+class WorkerArena;
+
 class UvChecker
 {
 public:
     static bool hasUvs(const Mesh& mesh);
-    static int countOverlappingUvIslands(const Mesh& mesh, std::vector<unsigned int>& overlapping_faces);
-    static int countUvsOutOfBounds(const Mesh& mesh);
+    // The rasterization grid and temporaries come from arena when given.
+    // Both counts stop growing once 'limit' says so; they are lower bounds then.
+    // The overlap rasterization reports its progress to 'limit'.
+    static int countOverlappingUvIslands(const Mesh& mesh, std::vector<unsigned int>& overlapping_faces, WorkerArena* arena = nullptr, const CheckLimit& limit = CheckLimit());
+    static int countUvsOutOfBounds(const Mesh& mesh, const CheckLimit& limit = CheckLimit());
 };
 
 #endif // UVCHECKER_H
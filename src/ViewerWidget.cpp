@@ -22,7 +22,7 @@ ViewerWidget::~ViewerWidget()
     clearMeshes();
 }
 
-void ViewerWidget::setMeshes(const std::vector<const Mesh*>& newMeshes, const MeshChecker::CheckResult* result, const std::vector<IntersectionResult>* intResult)
+void ViewerWidget::setMeshes(const std::vector<MeshView>& newMeshes, const MeshChecker::CheckResult* result, const std::vector<IntersectionResult>* intResult)
 {
     meshes = newMeshes;
     checkResult = result;
@@ -48,8 +48,8 @@ void ViewerWidget::focusOnMesh()
     glm::vec3 min_v(std::numeric_limits<float>::max());
     glm::vec3 max_v(std::numeric_limits<float>::lowest());
 
-    for (const auto& mesh : meshes) {
-        for (const auto& v : mesh->vertices) {
+    for (const auto& view : meshes) {
+        for (const auto& v : view.mesh->vertices) {
             min_v.x = std::min(min_v.x, v.x);
             min_v.y = std::min(min_v.y, v.y);
             min_v.z = std::min(min_v.z, v.z);
@@ -163,8 +163,9 @@ void ViewerWidget::paintGL()
 
     // --- Upload data to buffers ---
     for (size_t i = 0; i < meshes.size(); ++i) {
-        const auto& mesh = meshes[i];
+        const auto& mesh = meshes[i].mesh;
         if (!mesh) continue;
+        const std::vector<glm::vec3>& colors = meshes[i].colors ? *meshes[i].colors : mesh->colors;
 
         // Vertex Buffer
         glBindBuffer(GL_ARRAY_BUFFER, vbo_vertices_list[i]);
@@ -177,9 +178,9 @@ void ViewerWidget::paintGL()
         }
 
         // Color Buffer
-        if (!mesh->colors.empty()) {
+        if (!colors.empty()) {
             glBindBuffer(GL_ARRAY_BUFFER, vbo_colors_list[i]);
-            glBufferData(GL_ARRAY_BUFFER, mesh->colors.size() * sizeof(glm::vec3), mesh->colors.data(), GL_DYNAMIC_DRAW);
+            glBufferData(GL_ARRAY_BUFFER, colors.size() * sizeof(glm::vec3), colors.data(), GL_DYNAMIC_DRAW);
         }
 
         // Index Buffer
@@ -205,10 +206,11 @@ void ViewerWidget::paintGL()
     glTranslatef(-modelCenter.x, -modelCenter.y, -modelCenter.z);
 
     for (size_t i = 0; i < meshes.size(); ++i) {
-        const auto& mesh = meshes[i];
+        const auto& mesh = meshes[i].mesh;
         if (!mesh || i >= vbo_vertices_list.size() || vbo_vertices_list[i] == 0 || i >= ibo_indices_list.size() || ibo_indices_list[i] == 0) {
             continue;
         }
+        const std::vector<glm::vec3>& colors = meshes[i].colors ? *meshes[i].colors : mesh->colors;
 
         // --- Draw the main mesh using VBOs ---
         glEnable(GL_LIGHTING);
@@ -223,7 +225,7 @@ void ViewerWidget::paintGL()
             glNormalPointer(GL_FLOAT, 0, nullptr);
         }
 
-        if (i < vbo_colors_list.size() && vbo_colors_list[i] && !mesh->colors.empty()) {
+        if (i < vbo_colors_list.size() && vbo_colors_list[i] && !colors.empty()) {
             glEnableClientState(GL_COLOR_ARRAY);
             glBindBuffer(GL_ARRAY_BUFFER, vbo_colors_list[i]);
             glColorPointer(3, GL_FLOAT, 0, nullptr);
@@ -247,7 +249,7 @@ void ViewerWidget::paintGL()
         for (const auto& loop : checkResult->hole_loops) {
             glBegin(GL_LINE_LOOP);
             for (const auto& vertex_idx : loop) {
-                const auto& v = meshes[0]->vertices[vertex_idx];
+                const auto& v = meshes[0].mesh->vertices[vertex_idx];
                 glVertex3f(v.x, v.y, v.z);
             }
             glEnd();
@@ -5,6 +5,7 @@
 #include <QOpenGLFunctions>
 #include <glm/glm.hpp>
 #include "Mesh.h"
+#include "MeshHandle.h"
 #include "MeshChecker.h"
 #include "IntersectionResult.h"
 
@@ -17,7 +18,9 @@ public:
     ViewerWidget(QWidget *parent = nullptr);
     ~ViewerWidget();
 
-    void setMeshes(const std::vector<const Mesh*>& meshes, const MeshChecker::CheckResult* result, const std::vector<IntersectionResult>* intResult);
+    // The viewer keeps the handles until the next call or clearMeshes(); the
+    // color arrays must stay valid for as long.
+    void setMeshes(const std::vector<MeshView>& meshes, const MeshChecker::CheckResult* result, const std::vector<IntersectionResult>* intResult);
     void clearMeshes();
     void focusOnMesh();
 
@@ -43,7 +46,7 @@ private:
     void updateCameraStatus();
     void drawSphere(const glm::vec3& center, float radius);
 
-    std::vector<const Mesh*> meshes;
+    std::vector<MeshView> meshes;
     const std::vector<IntersectionResult>* intersectionResults = nullptr;
     const MeshChecker::CheckResult* checkResult = nullptr;
 
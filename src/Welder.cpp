@@ -0,0 +1,182 @@
+#include "Welder.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+// Vertices are processed in blocks of this size per task
+const size_t WELD_GRAIN = 1 << 14;
+
+struct CellEntry {
+    uint64_t key;
+    unsigned int vertex;
+};
+
+uint64_t mix(uint64_t x)
+{
+    // splitmix64 finalizer
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ull;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBull;
+    x ^= x >> 31;
+    return x;
+}
+
+// Hash of integer cell coordinates. Distinct cells may collide; that only
+// costs a few extra distance tests.
+uint64_t cellKey(int64_t x, int64_t y, int64_t z)
+{
+    return mix(static_cast<uint64_t>(x) + mix(static_cast<uint64_t>(y) + mix(static_cast<uint64_t>(z))));
+}
+
+int64_t floatBits(float value)
+{
+    value += 0.0f; // -0 and +0 weld together
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+} // namespace
+
+size_t Welder::weld(Mesh& mesh, float epsilon)
+{
+    const size_t num_vertices = mesh.vertices.size();
+    if (num_vertices < 2 || !(epsilon >= 0.0f)) {
+        return 0;
+    }
+
+    // With cells twice the tolerance, a vertex can only have neighbours in its
+    // own cell and in the one adjacent cell per axis on the side it is closer to.
+    const bool exact = epsilon == 0.0f;
+    const double cell_size = exact ? 1.0 : 2.0 * static_cast<double>(epsilon);
+    const double epsilon_sq = static_cast<double>(epsilon) * epsilon;
+    const double max_cell = 4.0e18;
+
+    std::vector<int64_t> cells(num_vertices * 3);
+    std::vector<unsigned char> mergeable(num_vertices, 0);
+    std::vector<CellEntry> entries(num_vertices);
+
+    Parallel::forRange(num_vertices, WELD_GRAIN, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const glm::vec3& p = mesh.vertices[i];
+            int64_t* cell = &cells[i * 3];
+            bool valid = std::isfinite(p.x) && std::isfinite(p.y) && std::isfinite(p.z);
+            for (int axis = 0; axis < 3 && valid; ++axis) {
+                if (exact) {
+                    cell[axis] = floatBits(p[axis]);
+                } else {
+                    const double scaled = std::floor(p[axis] / cell_size);
+                    valid = std::fabs(scaled) < max_cell;
+                    cell[axis] = valid ? static_cast<int64_t>(scaled) : 0;
+                }
+            }
+            mergeable[i] = valid;
+            // Non-finite vertices get a key of their own and are never looked up
+            entries[i].key = valid ? cellKey(cell[0], cell[1], cell[2]) : mix(i);
+            entries[i].vertex = static_cast<unsigned int>(i);
+        }
+    });
+
+    Parallel::sort(entries.begin(), entries.end(), [](const CellEntry& a, const CellEntry& b) {
+        return a.key < b.key || (a.key == b.key && a.vertex < b.vertex);
+    });
+
+    // Start of each run of equal keys
+    std::vector<uint64_t> cell_keys;
+    std::vector<size_t> cell_starts;
+    for (size_t i = 0; i < num_vertices; ++i) {
+        if (i == 0 || entries[i].key != entries[i - 1].key) {
+            cell_keys.push_back(entries[i].key);
+            cell_starts.push_back(i);
+        }
+    }
+    cell_starts.push_back(num_vertices);
+
+    // Each vertex points at the lowest-numbered vertex within the tolerance
+    std::vector<unsigned int> representative(num_vertices);
+    Parallel::forRange(num_vertices, WELD_GRAIN, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            unsigned int best = static_cast<unsigned int>(i);
+            if (mergeable[i]) {
+                const glm::vec3& p = mesh.vertices[i];
+                const int64_t* cell = &cells[i * 3];
+                int64_t offsets[3] = {0, 0, 0};
+                if (!exact) {
+                    for (int axis = 0; axis < 3; ++axis) {
+                        const double fraction = p[axis] / cell_size - static_cast<double>(cell[axis]);
+                        offsets[axis] = fraction < 0.5 ? -1 : 1;
+                    }
+                }
+                const int num_neighbours = exact ? 1 : 8;
+                for (int n = 0; n < num_neighbours; ++n) {
+                    const uint64_t key = cellKey(cell[0] + ((n & 1) ? offsets[0] : 0),
+                                                 cell[1] + ((n & 2) ? offsets[1] : 0),
+                                                 cell[2] + ((n & 4) ? offsets[2] : 0));
+                    auto found = std::lower_bound(cell_keys.begin(), cell_keys.end(), key);
+                    if (found == cell_keys.end() || *found != key) {
+                        continue;
+                    }
+                    const size_t c = found - cell_keys.begin();
+                    // Entries within a cell are sorted by vertex, so stop at the current best
+                    for (size_t e = cell_starts[c]; e < cell_starts[c + 1] && entries[e].vertex < best; ++e) {
+                        const unsigned int j = entries[e].vertex;
+                        if (!mergeable[j]) {
+                            continue;
+                        }
+                        const glm::vec3& q = mesh.vertices[j];
+                        const double dx = static_cast<double>(p.x) - q.x;
+                        const double dy = static_cast<double>(p.y) - q.y;
+                        const double dz = static_cast<double>(p.z) - q.z;
+                        if (dx * dx + dy * dy + dz * dz <= epsilon_sq) {
+                            best = j;
+                            break;
+                        }
+                    }
+                }
+            }
+            representative[i] = best;
+        }
+    });
+
+    // Representatives always have lower indices, so one ascending pass
+    // resolves chains and assigns the compacted indices.
+    std::vector<unsigned int> new_index(num_vertices);
+    size_t kept = 0;
+    for (size_t i = 0; i < num_vertices; ++i) {
+        const unsigned int r = representative[i];
+        if (r == i) {
+            new_index[i] = static_cast<unsigned int>(kept);
+            mesh.vertices[kept] = mesh.vertices[i];
+            if (mesh.colors.size() == num_vertices) {
+                mesh.colors[kept] = mesh.colors[i];
+            }
+            ++kept;
+        } else {
+            new_index[i] = new_index[r];
+        }
+    }
+    if (kept == num_vertices) {
+        return 0;
+    }
+    mesh.vertices.resize(kept);
+    if (mesh.colors.size() == num_vertices) {
+        mesh.colors.resize(kept);
+    }
+
+    Parallel::forRange(mesh.vertex_indices.size(), WELD_GRAIN, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            unsigned int& index = mesh.vertex_indices[i];
+            if (index < num_vertices) {
+                index = new_index[index];
+            }
+        }
+    });
+
+    return num_vertices - kept;
+}
@@ -0,0 +1,18 @@
+#ifndef WELDER_H
+#define WELDER_H
+
+#include "Mesh.h"
+#include <cstddef>
+
+// Merges vertices that lie within a distance tolerance of each other and
+// rewrites the vertex indices to use the merged positions. Faces are kept in
+// place, so per-face arrays such as uv_indices stay aligned.
+class Welder
+{
+public:
+    // Returns the number of vertices removed. An epsilon of 0 merges exact
+    // duplicates only. Non-finite positions are never merged.
+    static size_t weld(Mesh& mesh, float epsilon);
+};
+
+#endif // WELDER_H
@@ -0,0 +1,17 @@
+#include "WorkerArena.h"
+
+WorkerArena::WorkerArena()
+    : pool(std::pmr::pool_options{0, 1 << 20})
+{
+}
+
+void WorkerArena::reset()
+{
+    mesh.vertices.clear();
+    mesh.uvs.clear();
+    mesh.colors.clear();
+    mesh.normals.clear();
+    mesh.vertex_indices.clear();
+    mesh.uv_indices.clear();
+    mesh.normal_indices.clear();
+}
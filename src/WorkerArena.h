@@ -0,0 +1,45 @@
+#ifndef WORKERARENA_H
+#define WORKERARENA_H
+
+#include "Mesh.h"
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+// Memory a batch worker keeps from one file to the next. The mesh and the
+// large scratch buffers are cleared rather than freed, so once a worker has
+// seen its largest file it stops going back to malloc. Short-lived sets, maps
+// and vectors inside the checks are allocated from resource(), a pool that
+// recycles its blocks the same way.
+//
+// Use one arena per worker thread. The pool is synchronized because
+// MeshChecker::check runs its checks concurrently; the buffers are not shared
+// between checks.
+class WorkerArena
+{
+public:
+    WorkerArena();
+
+    std::pmr::memory_resource* resource() { return &pool; }
+
+    // Empties the mesh between files without releasing its capacity.
+    void reset();
+
+    Mesh mesh;
+
+    // Rasterization grid of UvChecker::countOverlappingUvIslands
+    std::vector<int> uv_grid;
+
+    // CGAL soup buffers of MeshChecker::check. Type-erased so that this header
+    // does not depend on CGAL; MeshChecker.cpp creates and casts it.
+    std::shared_ptr<void> checker_buffers;
+
+    // OBJ parser output and chunk buffers of ObjLoader, type-erased the same
+    // way so that this header does not depend on tinyobj
+    std::shared_ptr<void> loader_buffers;
+
+private:
+    std::pmr::synchronized_pool_resource pool;
+};
+
+#endif // WORKERARENA_H
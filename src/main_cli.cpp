@@ -3,23 +3,61 @@
 #include <vector>
 #include <filesystem>
 #include <fstream>
-#include <thread>
-#include <queue>
 #include <mutex>
-#include <condition_variable>
+#include <chrono>
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <unordered_map>
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
 #include "Mesh.h"
+#include "MeshSoA.h"
+#include "CompactMesh.h"
+#include "MeshFingerprint.h"
+#include "PagedMesh.h"
+#include "PagedMeshChecker.h"
 #include "ObjLoader.h"
+#include "MeshCache.h"
+#include "MeshLoader.h"
 #include "MeshChecker.h"
+#include "UvChecker.h"
+#include "Parallel.h"
+#include "TaskScheduler.h"
+#include "WorkerArena.h"
 
 namespace fs = std::filesystem;
 
 
-void printResult(const MeshChecker::CheckResult& result) {
+void printResult(const MeshChecker::CheckResult& result, bool uvsChecked = true) {
     std::cout << "  Watertight: " << (result.is_watertight ? "Yes" : "No") << std::endl;
     std::cout << "  Non-manifold vertices: " << result.non_manifold_vertices_count << std::endl;
     std::cout << "  Self-intersections: " << result.self_intersections_count << std::endl;
     std::cout << "  Holes: " << result.holes_count << std::endl;
+    // Largest holes first, so the ones worth fixing are at the top
+    std::vector<size_t> holes(result.hole_metrics.size());
+    for (size_t i = 0; i < holes.size(); ++i) {
+        holes[i] = i;
+    }
+    const size_t shownHoles = std::min<size_t>(holes.size(), 5);
+    std::partial_sort(holes.begin(), holes.begin() + shownHoles, holes.end(), [&](size_t a, size_t b) {
+        return result.hole_metrics[a].area > result.hole_metrics[b].area;
+    });
+    for (size_t i = 0; i < shownHoles; ++i) {
+        const MeshChecker::HoleMetrics& hole = result.hole_metrics[holes[i]];
+        const glm::vec3 size = hole.bounds.max - hole.bounds.min;
+        std::cout << "    Hole " << holes[i] << ": " << result.hole_loops[holes[i]].size() << " edges, perimeter "
+                  << hole.perimeter << ", area " << hole.area << ", size "
+                  << size.x << " x " << size.y << " x " << size.z << std::endl;
+    }
     std::cout << "  Degenerate faces: " << result.degenerate_faces_count << std::endl;
+    if (!uvsChecked) {
+        return;
+    }
     std::cout << "  Has UVs: " << (result.has_uvs ? "Yes" : "No") << std::endl;
     if (result.has_uvs) {
         std::cout << "  Overlapping UVs: " << result.overlapping_uv_islands_count << std::endl;
@@ -27,32 +65,375 @@ void printResult(const MeshChecker::CheckResult& result) {
     }
 }
 
+// Checks that ran out of time, by their CSV column names, separated by ';'
+std::string timedOutChecks(const MeshChecker::CheckResult& result) {
+    std::string names;
+    for (MeshChecker::CheckType check : result.timed_out_checks) {
+        if (!names.empty()) {
+            names += ";";
+        }
+        names += MeshChecker::checkName(check);
+    }
+    return names;
+}
+
+// Gate mode exit code when a mesh fails a check. Load errors keep 1, and
+// take precedence in batch mode.
+const int GATE_FAILED = 2;
+
+// Checks a loaded mesh. In compact mode the mesh is first converted to a
+// CompactMesh and released, so the CGAL checks run next to the smaller copy.
+MeshChecker::CheckResult checkMesh(Mesh& mesh, const std::set<MeshChecker::CheckType>& checks,
+                                   const MeshCheckOptions& options, bool compact, bool quantize) {
+    if (!compact) {
+        return MeshChecker::check(mesh, checks, options);
+    }
+    CompactMesh compactMesh = CompactMesh::fromMesh(mesh, quantize);
+    mesh = Mesh();
+    return MeshChecker::check(compactMesh, checks, options);
+}
+
+// Checks a mesh through an out-of-core store. The loaded mesh is written to
+// a store file in the temp directory and released, and the streaming checks
+// then run within memoryMb of mapped pages and edge partitions.
+int runPagedCheck(const std::string& filePath, const MeshLoadOptions& loadOptions, size_t memoryMb,
+                  const DegenerateThresholds& thresholds, bool gate) {
+    // The pid keeps the store and its edge scratch files apart from those of
+    // another run checking a file of the same name
+    std::string storePath = (fs::temp_directory_path() /
+                             (fs::path(filePath).filename().string() + "." + std::to_string(getpid()) + ".pagedmesh")).string();
+    {
+        Mesh mesh;
+        if (!MeshLoader::load(filePath, mesh, loadOptions)) {
+            std::cerr << "Error loading file: " << filePath << std::endl;
+            return 1;
+        }
+        if (!PagedMesh::write(storePath, mesh)) {
+            std::cerr << "Error writing paged store: " << storePath << std::endl;
+            return 1;
+        }
+    }
+
+    // Half of the budget for mapped pages, half for sorting edge partitions
+    const size_t budgetBytes = memoryMb << 20;
+    PagedMesh paged;
+    if (!paged.open(storePath, budgetBytes / 2 / (PagedMesh::PAGE_ELEMENTS * sizeof(glm::vec3)))) {
+        std::cerr << "Error opening paged store: " << storePath << std::endl;
+        fs::remove(storePath);
+        return 1;
+    }
+    std::cout << "Checking " << filePath << " out of core (" << paged.faceCount() << " faces)..." << std::endl;
+    PagedMeshChecker::Result result = PagedMeshChecker::check(paged, storePath + ".edges", budgetBytes / 2, thresholds);
+    paged.close();
+    fs::remove(storePath);
+
+    if (!result.degenerates_counted) {
+        std::cerr << "  Degenerate face check failed: could not map store pages" << std::endl;
+    }
+    if (!result.uvs_counted) {
+        std::cerr << "  UV bounds check failed: could not map store pages" << std::endl;
+    }
+    if (result.edges_counted) {
+        std::cout << "  Watertight: " << (result.is_watertight ? "Yes" : "No") << std::endl;
+        std::cout << "  Boundary edges: " << result.boundary_edges_count << std::endl;
+        std::cout << "  Non-manifold edges: " << result.non_manifold_edges_count << std::endl;
+    } else {
+        std::cerr << "  Edge counting failed: could not write scratch files" << std::endl;
+    }
+    if (result.degenerates_counted) {
+        std::cout << "  Degenerate faces: " << result.degenerate_faces_count << std::endl;
+    }
+    std::cout << "  Has UVs: " << (result.has_uvs ? "Yes" : "No") << std::endl;
+    if (result.has_uvs && result.uvs_counted) {
+        std::cout << "  UVs out of bounds: " << result.uvs_out_of_bounds_count << std::endl;
+    }
+    if (!result.edges_counted || !result.degenerates_counted || !result.uvs_counted) {
+        return 1;
+    }
+    if (gate) {
+        // The streamed checks run to completion, so every count is exact
+        const bool passed = result.is_watertight && result.non_manifold_edges_count == 0 &&
+                            result.degenerate_faces_count == 0 && result.uvs_out_of_bounds_count == 0;
+        std::cout << "Gate: " << (passed ? "PASS" : "FAIL") << std::endl;
+        if (!passed) {
+            return GATE_FAILED;
+        }
+    }
+    return 0;
+}
+
+// Scalar sweep over the AoS mesh with DegenerateChecker's per-face test, as
+// the baseline for the SoA kernel.
+int countDegenerateFacesAoS(const Mesh& mesh) {
+    const DegenerateChecker::Bounds bounds{DegenerateThresholds()};
+    int count = 0;
+    for (size_t i = 0; i + 2 < mesh.vertex_indices.size(); i += 3) {
+        if (DegenerateChecker::isDegenerate(mesh.vertices[mesh.vertex_indices[i]], mesh.vertices[mesh.vertex_indices[i + 1]],
+                                            mesh.vertices[mesh.vertex_indices[i + 2]], bounds)) {
+            count++;
+        }
+    }
+    return count;
+}
+
+// Best wall time of `repeat` runs, in milliseconds.
+template <typename Function>
+double bestTimeMs(int repeat, const Function& function) {
+    double best = 0.0;
+    for (int i = 0; i < repeat; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (i == 0 || elapsed < best) {
+            best = elapsed;
+        }
+    }
+    return best;
+}
+
+// The speedup compares the two layouts on one thread; the threaded SoA time
+// is reported separately.
+void printBenchmarkRow(const std::string& name, double aos_ms, double soa_ms, double soa_threaded_ms, bool same) {
+    std::cout << "  " << name << ": AoS " << aos_ms << " ms, SoA " << soa_ms << " ms, speedup "
+              << (soa_ms > 0.0 ? aos_ms / soa_ms : 0.0) << "x; SoA on " << Parallel::threadCount() << " threads "
+              << soa_threaded_ms << " ms" << (same ? "" : "  (RESULTS DIFFER)") << std::endl;
+}
+
+// Times the AoS kernels against their SoA counterparts on one mesh. The AoS
+// kernels are serial, so the SoA kernels are timed on one thread for the
+// comparison and then again on every scheduler thread.
+int runBenchmark(const std::string& filePath, int repeat) {
+    MeshLoadOptions options;
+    options.keep_normals = false;
+    Mesh mesh;
+    double loadMs = bestTimeMs(1, [&]() { MeshLoader::load(filePath, mesh, options); });
+    if (mesh.vertices.empty()) {
+        std::cerr << "Error loading file: " << filePath << std::endl;
+        return 1;
+    }
+    std::cout << "Benchmark " << filePath << ": " << mesh.vertices.size() << " vertices, "
+              << mesh.vertex_indices.size() / 3 << " faces, " << mesh.uv_indices.size() << " UV corners, "
+              << Parallel::threadCount() << " threads, best of " << repeat << std::endl;
+
+    MeshSoA soa;
+    double convertMs = bestTimeMs(repeat, [&]() { soa = MeshSoA::fromMesh(mesh); });
+    std::cout << "  Load: " << loadMs << " ms, AoS to SoA conversion: " << convertMs << " ms" << std::endl;
+
+    std::string lowerPath = filePath;
+    std::transform(lowerPath.begin(), lowerPath.end(), lowerPath.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    if (lowerPath.size() > 4 && lowerPath.compare(lowerPath.size() - 4, 4, ".obj") == 0) {
+        MeshSoA direct;
+        double directMs = bestTimeMs(1, [&]() { ObjLoader::load_soa(filePath, direct, options); });
+        std::cout << "  Direct OBJ to SoA load: " << directMs << " ms" << std::endl;
+    }
+
+    const unsigned int threads = Parallel::threadCount();
+    double soaMs = 0.0, soaThreadedMs = 0.0;
+    auto timeSoa = [&](const auto& kernel) {
+        TaskScheduler::getInstance().setThreadCount(1);
+        soaMs = bestTimeMs(repeat, kernel);
+        TaskScheduler::getInstance().setThreadCount(threads);
+        soaThreadedMs = bestTimeMs(repeat, kernel);
+    };
+
+    BoundingBox aosBox, soaBox;
+    double aosMs = bestTimeMs(repeat, [&]() { aosBox = mesh.getBoundingBox(); });
+    timeSoa([&]() { soaBox = soa.boundingBox(); });
+    printBenchmarkRow("Bounding box", aosMs, soaMs, soaThreadedMs, aosBox.min == soaBox.min && aosBox.max == soaBox.max);
+
+    int aosCount = 0, soaCount = 0;
+    aosMs = bestTimeMs(repeat, [&]() { aosCount = countDegenerateFacesAoS(mesh); });
+    timeSoa([&]() { soaCount = soa.countDegenerateFaces(); });
+    printBenchmarkRow("Degenerate faces (" + std::to_string(soaCount) + ")", aosMs, soaMs, soaThreadedMs, aosCount == soaCount);
+
+    aosMs = bestTimeMs(repeat, [&]() { aosCount = UvChecker::countUvsOutOfBounds(mesh); });
+    timeSoa([&]() { soaCount = soa.countUvsOutOfBounds(); });
+    printBenchmarkRow("UVs out of bounds (" + std::to_string(soaCount) + ")", aosMs, soaMs, soaThreadedMs, aosCount == soaCount);
+    return 0;
+}
+
 int main(int argc, char* argv[]) {
     if (argc < 3) {
-        std::cerr << "Usage: ApparelMeshChecker-cli --single <file.obj>" << std::endl;
-        std::cerr << "       ApparelMeshChecker-cli --batch <folder_path> [--output <results.csv>] [--threads <N|auto>]" << std::endl;
+        std::cerr << "Usage: ApparelMeshChecker-cli --single <mesh file> [--threads <N|auto>] [--loader <mapped|tinyobj>] [--cache-dir <dir>] [--cache-max-mb <N>] [--weld <epsilon>] [--compact] [--quantize] [--serial-self-intersections] [--topology <halfedge|edges|cross>] [--min-face-area <A>] [--max-aspect-ratio <R>] [--gate [--limit <N>]] [--time-budget <seconds>] [--paged [--paged-memory-mb <N>]] (--paged excludes --limit and --time-budget)" << std::endl;
+        std::cerr << "       ApparelMeshChecker-cli --batch <folder_path> [--output <results.csv>] [--threads <N|auto>] [--loader <mapped|tinyobj>] [--cache-dir <dir>] [--cache-max-mb <N>] [--weld <epsilon>] [--compact] [--quantize] [--serial-self-intersections] [--topology <halfedge|edges|cross>] [--min-face-area <A>] [--max-aspect-ratio <R>] [--gate [--limit <N>]] [--time-budget <seconds>] [--skip-duplicates]" << std::endl;
+        std::cerr << "       ApparelMeshChecker-cli --fingerprint <mesh file> [--weld <epsilon>]" << std::endl;
+        std::cerr << "       ApparelMeshChecker-cli --bench <mesh file> [--repeat <N>] [--threads <N|auto>]" << std::endl;
         std::cerr << "       ApparelMeshChecker-cli --intersect --mannequin <mannequin.obj> --apparel <apparel1.obj> ..." << std::endl;
         return 1;
     }
 
     std::string mode = argv[1];
+    std::string cacheDir;
+    uint64_t cacheMaxMb = 4096;
+    float weldEpsilon = -1.0f;
+    bool compact = false;
+    bool quantize = false;
+    bool paged = false;
+    size_t pagedMemoryMb = 2048;
+    unsigned int numThreads = 0;
+    bool serialSelfIntersections = false;
+    MeshCheckOptions::Topology topology = MeshCheckOptions::Topology::HalfedgeMesh;
+    DegenerateThresholds degenerateThresholds;
+    bool gate = false;
+    size_t violationLimit = 0;
+    double timeBudgetSeconds = 0.0;
+
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--loader" && i + 1 < argc) {
+            std::string val = argv[++i];
+            if (val == "tinyobj") {
+                ObjLoader::setBackend(ObjLoader::Backend::TinyObj);
+            } else if (val == "mapped") {
+                ObjLoader::setBackend(ObjLoader::Backend::MappedParallel);
+            } else {
+                std::cerr << "Unknown loader: " << val << std::endl;
+                return 1;
+            }
+        } else if (arg == "--cache-dir" && i + 1 < argc) {
+            cacheDir = argv[++i];
+        } else if (arg == "--cache-max-mb" && i + 1 < argc) {
+            cacheMaxMb = std::stoull(argv[++i]);
+        } else if (arg == "--weld" && i + 1 < argc) {
+            weldEpsilon = std::stof(argv[++i]);
+            if (weldEpsilon < 0.0f) {
+                std::cerr << "Weld epsilon must not be negative" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--compact") {
+            compact = true;
+        } else if (arg == "--quantize") {
+            compact = true;
+            quantize = true;
+        } else if (arg == "--threads" && i + 1 < argc) {
+            std::string val = argv[++i];
+            numThreads = val == "auto" ? 0 : std::max(1, std::stoi(val));
+        } else if (arg == "--serial-self-intersections") {
+            serialSelfIntersections = true;
+        } else if (arg == "--topology" && i + 1 < argc) {
+            std::string val = argv[++i];
+            if (val == "halfedge") {
+                topology = MeshCheckOptions::Topology::HalfedgeMesh;
+            } else if (val == "edges") {
+                topology = MeshCheckOptions::Topology::EdgeTable;
+            } else if (val == "cross") {
+                topology = MeshCheckOptions::Topology::CrossValidate;
+            } else {
+                std::cerr << "Unknown topology path: " << val << std::endl;
+                return 1;
+            }
+        } else if (arg == "--min-face-area" && i + 1 < argc) {
+            degenerateThresholds.min_area = std::stod(argv[++i]);
+        } else if (arg == "--max-aspect-ratio" && i + 1 < argc) {
+            degenerateThresholds.max_aspect_ratio = std::stod(argv[++i]);
+        } else if (arg == "--gate") {
+            gate = true;
+        } else if (arg == "--limit" && i + 1 < argc) {
+            violationLimit = std::stoull(argv[++i]);
+        } else if (arg == "--time-budget" && i + 1 < argc) {
+            timeBudgetSeconds = std::stod(argv[++i]);
+        } else if (arg == "--paged") {
+            paged = true;
+        } else if (arg == "--paged-memory-mb" && i + 1 < argc) {
+            pagedMemoryMb = std::max<size_t>(16, std::stoull(argv[++i]));
+        }
+    }
+
+    // The streamed checks have no early stop
+    if (paged && (violationLimit > 0 || timeBudgetSeconds > 0.0)) {
+        std::cerr << "--limit and --time-budget cannot be combined with --paged" << std::endl;
+        return 1;
+    }
+
+    // One thread count for everything: files, checks and the loops inside them
+    TaskScheduler::getInstance().setThreadCount(numThreads);
+
+    if (!cacheDir.empty()) {
+        MeshCache::getInstance().init(cacheDir, cacheMaxMb << 20);
+    }
+
+    // A welded mesh no longer needs CGAL's serial soup repair
+    MeshCheckOptions checkOptions;
+    checkOptions.repair_soup = weldEpsilon < 0.0f;
+    checkOptions.parallel_self_intersections = !serialSelfIntersections;
+    checkOptions.topology = topology;
+    checkOptions.degenerate_thresholds = degenerateThresholds;
+    // Gate mode only needs pass or fail: checks stop at the first violation
+    // (or --limit of them) and the rest stop once one check has failed
+    if (gate) {
+        checkOptions.stop_on_failure = true;
+        checkOptions.violation_limit = violationLimit == 0 ? 1 : violationLimit;
+    } else {
+        checkOptions.violation_limit = violationLimit;
+    }
+    // A pathological file gives up on the slow check instead of holding a
+    // worker; the result says which checks ran out of time
+    checkOptions.check_time_budget = std::chrono::milliseconds(static_cast<long long>(timeBudgetSeconds * 1000.0));
 
-    if (mode == "--single") {
+    std::set<MeshChecker::CheckType> allChecks = {
+        MeshChecker::CheckType::Watertight,
+        MeshChecker::CheckType::NonManifold,
+        MeshChecker::CheckType::SelfIntersect,
+        MeshChecker::CheckType::Holes,
+        MeshChecker::CheckType::DegenerateFaces,
+        MeshChecker::CheckType::UVOverlap,
+        MeshChecker::CheckType::UVBounds
+    };
+    // Compact meshes carry no UVs
+    if (compact) {
+        allChecks.erase(MeshChecker::CheckType::UVOverlap);
+        allChecks.erase(MeshChecker::CheckType::UVBounds);
+    }
+
+    if (mode == "--bench") {
+        int repeat = 5;
+        for (int i = 3; i < argc; ++i) {
+            if (std::string(argv[i]) == "--repeat" && i + 1 < argc) {
+                repeat = std::max(1, std::stoi(argv[++i]));
+            }
+        }
+        return runBenchmark(argv[2], repeat);
+    } else if (mode == "--fingerprint") {
+        std::string filePath = argv[2];
+        MeshLoadOptions loadOptions;
+        loadOptions.keep_normals = false;
+        loadOptions.weld_epsilon = weldEpsilon;
+        Mesh mesh;
+        if (!MeshLoader::load(filePath, mesh, loadOptions)) {
+            std::cerr << "Error loading file: " << filePath << std::endl;
+            return 1;
+        }
+        MeshFingerprint fingerprint = MeshFingerprint::compute(mesh);
+        std::cout << fingerprint.toString() << "  " << filePath << std::endl;
+    } else if (mode == "--single") {
         std::string filePath = argv[2];
+        MeshLoadOptions loadOptions = MeshChecker::requiredAttributes(allChecks);
+        loadOptions.weld_epsilon = weldEpsilon;
+        if (paged) {
+            return runPagedCheck(filePath, loadOptions, pagedMemoryMb, degenerateThresholds, gate);
+        }
         Mesh mesh;
-        if (ObjLoader::load_indexed(filePath, mesh)) {
+        size_t weldedVertices = 0;
+        if (MeshLoader::load(filePath, mesh, loadOptions, &weldedVertices)) {
+            if (weldEpsilon >= 0.0f) {
+                std::cout << "Welded " << weldedVertices << " vertices" << std::endl;
+            }
             std::cout << "Checking " << filePath << "..." << std::endl;
-            std::set<MeshChecker::CheckType> allChecks = {
-                MeshChecker::CheckType::Watertight,
-                MeshChecker::CheckType::NonManifold,
-                MeshChecker::CheckType::SelfIntersect,
-                MeshChecker::CheckType::Holes,
-                MeshChecker::CheckType::DegenerateFaces,
-                MeshChecker::CheckType::UVOverlap,
-                MeshChecker::CheckType::UVBounds
-            };
-            MeshChecker::CheckResult result = MeshChecker::check(mesh, allChecks);
-            printResult(result);
+            MeshChecker::CheckResult result = checkMesh(mesh, allChecks, checkOptions, compact, quantize);
+            printResult(result, !compact);
+            if (result.stopped_early) {
+                std::cout << "  (stopped early; counts are lower bounds)" << std::endl;
+            }
+            if (!result.timed_out_checks.empty()) {
+                std::cout << "  Timed out: " << timedOutChecks(result) << std::endl;
+            }
+            if (gate) {
+                const bool passed = MeshChecker::passes(result, allChecks);
+                std::cout << "Gate: " << (passed ? "PASS" : "FAIL") << std::endl;
+                if (!passed) {
+                    return GATE_FAILED;
+                }
+            }
         } else {
             std::cerr << "Error loading file: " << filePath << std::endl;
             return 1;
@@ -60,95 +441,119 @@ int main(int argc, char* argv[]) {
     } else if (mode == "--batch") {
         std::string folderPath = argv[2];
         std::string outputPath = "results.csv";
-        unsigned int num_threads = std::thread::hardware_concurrency();
+        bool skipDuplicates = false;
 
         for (int i = 3; i < argc; ++i) {
             std::string arg = argv[i];
             if (arg == "--output" && i + 1 < argc) {
                 outputPath = argv[++i];
-            } else if (arg == "--threads" && i + 1 < argc) {
-                std::string val = argv[++i];
-                if (val == "auto") {
-                    num_threads = std::thread::hardware_concurrency();
-                } else {
-                    num_threads = std::stoi(val);
-                }
+            } else if (arg == "--skip-duplicates") {
+                skipDuplicates = true;
             }
         }
 
         std::ofstream outputFile(outputPath);
-        outputFile << "File,Watertight,NonManifoldVertices,SelfIntersections,Holes,DegenerateFaces,HasUVs,OverlappingUVs,UVsOutOfBounds\n";
+        // With --skip-duplicates every file still gets a row; a skipped copy
+        // names the checked file its results are in under DuplicateOf
+        outputFile << "File,Watertight,NonManifoldVertices,SelfIntersections,Holes,DegenerateFaces,HasUVs,OverlappingUVs,UVsOutOfBounds,TimedOut"
+                   << (skipDuplicates ? ",DuplicateOf" : "") << (gate ? ",Passed\n" : "\n");
 
-        std::queue<std::string> fileQueue;
+        std::vector<std::string> files;
         for (const auto& entry : fs::directory_iterator(folderPath)) {
-            if (entry.is_regular_file() && entry.path().extension() == ".obj") {
-                fileQueue.push(entry.path().string());
+            if (entry.is_regular_file() && MeshLoader::isSupported(entry.path().string())) {
+                files.push_back(entry.path().string());
             }
         }
 
-        std::mutex queueMutex;
         std::mutex outputMutex;
-        std::condition_variable cv;
-        bool done = false;
-
-        auto worker = [&]() {
-            while (true) {
-                std::string filePath;
-                {
-                    std::unique_lock<std::mutex> lock(queueMutex);
-                    cv.wait(lock, [&] { return !fileQueue.empty() || done; });
-                    if (fileQueue.empty() && done) {
+        // Gate mode: set when any file fails a check, or cannot be loaded
+        std::atomic<bool> anyFailed(false);
+        std::atomic<bool> anyLoadError(false);
+
+        // First file seen with each fingerprint; later copies are not checked
+        std::unordered_map<MeshFingerprint, std::string, MeshFingerprintHasher> seenMeshes;
+        std::mutex seenMutex;
+
+        // Each file is one scheduler task; its checks and loops are tasks too
+        auto processFile = [&](const std::string& filePath) {
+            // Buffers grow to the largest file a scheduler thread sees and are
+            // reused. Waiting threads only run tasks of the file they are
+            // checking, so two files never share an arena at the same time.
+            static thread_local WorkerArena arena;
+            MeshCheckOptions workerCheckOptions = checkOptions;
+            workerCheckOptions.arena = &arena;
+
+            MeshLoadOptions loadOptions = MeshChecker::requiredAttributes(allChecks);
+            loadOptions.weld_epsilon = weldEpsilon;
+            loadOptions.arena = &arena;
+            arena.reset();
+            Mesh& mesh = arena.mesh;
+            size_t weldedVertices = 0;
+            if (MeshLoader::load(filePath, mesh, loadOptions, &weldedVertices)) {
+                if (weldEpsilon >= 0.0f) {
+                    std::cout << "Welded " << weldedVertices << " vertices in " << filePath << std::endl;
+                }
+                if (skipDuplicates) {
+                    MeshFingerprint fingerprint = MeshFingerprint::compute(mesh);
+                    std::lock_guard<std::mutex> lock(seenMutex);
+                    auto inserted = seenMeshes.emplace(fingerprint, filePath);
+                    if (!inserted.second) {
+                        std::cout << "Skipping " << filePath << " (same mesh as " << inserted.first->second << ")" << std::endl;
+                        std::lock_guard<std::mutex> outputLock(outputMutex);
+                        outputFile << filePath << ",,,,,,,,,," << inserted.first->second << (gate ? ",\n" : "\n");
                         return;
                     }
-                    filePath = fileQueue.front();
-                    fileQueue.pop();
+                }
+                std::cout << "Checking " << filePath << "..." << std::endl;
+                MeshChecker::CheckResult result = checkMesh(mesh, allChecks, workerCheckOptions, compact, quantize);
+                const bool passed = MeshChecker::passes(result, allChecks);
+                if (!passed) {
+                    anyFailed = true;
                 }
 
-                Mesh mesh;
-                if (ObjLoader::load_indexed(filePath, mesh)) {
-                    std::cout << "Checking " << filePath << "..." << std::endl;
-                    std::set<MeshChecker::CheckType> allChecks = {
-                        MeshChecker::CheckType::Watertight,
-                        MeshChecker::CheckType::NonManifold,
-                        MeshChecker::CheckType::SelfIntersect,
-                        MeshChecker::CheckType::Holes,
-                        MeshChecker::CheckType::DegenerateFaces,
-                        MeshChecker::CheckType::UVOverlap,
-                        MeshChecker::CheckType::UVBounds
-                    };
-                    MeshChecker::CheckResult result = MeshChecker::check(mesh, allChecks);
-
-                    std::lock_guard<std::mutex> lock(outputMutex);
-                    outputFile << filePath << ","
-                               << (result.is_watertight ? "Yes" : "No") << ","
-                               << result.non_manifold_vertices_count << ","
-                               << result.self_intersections_count << ","
-                               << result.holes_count << ","
-                               << result.degenerate_faces_count << ","
-                               << (result.has_uvs ? "Yes" : "No") << ","
-                               << result.overlapping_uv_islands_count << ","
-                               << result.uvs_out_of_bounds_count << "\n";
+                std::lock_guard<std::mutex> lock(outputMutex);
+                outputFile << filePath << ","
+                           << (result.is_watertight ? "Yes" : "No") << ","
+                           << result.non_manifold_vertices_count << ","
+                           << result.self_intersections_count << ","
+                           << result.holes_count << ","
+                           << result.degenerate_faces_count << ",";
+                if (compact) {
+                    outputFile << ",,";
                 } else {
-                    std::cerr << "Error loading file: " << filePath << std::endl;
+                    outputFile << (result.has_uvs ? "Yes" : "No") << ","
+                               << result.overlapping_uv_islands_count << ","
+                               << result.uvs_out_of_bounds_count;
+                }
+                outputFile << "," << timedOutChecks(result);
+                if (skipDuplicates) {
+                    outputFile << ",";
                 }
+                if (gate) {
+                    outputFile << "," << (passed ? "Yes" : "No");
+                }
+                outputFile << "\n";
+            } else {
+                std::cerr << "Error loading file: " << filePath << std::endl;
+                anyLoadError = true;
             }
         };
 
-        std::vector<std::thread> threads;
-        for (unsigned int i = 0; i < num_threads; ++i) {
-            threads.emplace_back(worker);
-        }
-
-        {
-            std::unique_lock<std::mutex> lock(queueMutex);
-            done = true;
+        TaskGroup fileTasks;
+        for (const std::string& filePath : files) {
+            fileTasks.run([&processFile, filePath]() { processFile(filePath); });
         }
-        cv.notify_all();
+        fileTasks.wait();
 
-        for (auto& thread : threads) {
-            thread.join();
+        if (gate) {
+            std::cout << "Gate: " << (anyFailed || anyLoadError ? "FAIL" : "PASS") << std::endl;
+            if (anyLoadError) {
+                return 1;
+            }
+            if (anyFailed) {
+                return GATE_FAILED;
+            }
         }
-
     } else if (mode == "--intersect") {
         // ... intersection logic
     }